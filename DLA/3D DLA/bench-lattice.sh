@@ -0,0 +1,43 @@
+#!/bin/bash
+# compares the lattice layouts on the same clusters: the fixed grid in row-major order (-DDLA_FLAT_LATTICE),
+# the fixed grid in Morton order (-DDLA_MORTON_LATTICE) and the chunked lattice (the default)
+# the random numbers do not depend on the layout, so every layout grows exactly the same cluster
+# usage: ./bench-lattice.sh [endNum ...]    (default 10000 100000 1000000)
+# GRID sets DLA_GRID_SIZE: the killCircle is about twice the cluster radius, so a 10^6 cluster
+# (radius about 430) needs 2048, which is 4 GB for the fixed grids
+# SEED, PROB and OPTIONS (default --pyramid) are passed on to dla-batch
+# needs make and g++ (or CXX=...), it builds dla-batch once per layout into bench/ and runs it from there
+# (the objects it leaves behind were built with its CPPFLAGS, so the next plain make rebuilds them)
+
+SIZES=${@:-10000 100000 1000000}
+GRID=${GRID:-2048}
+SEED=${SEED:-6}
+PROB=${PROB:-1}
+OPTIONS=${OPTIONS:---pyramid}
+CXX=${CXX:-g++}
+
+cd "$(dirname "$0")" || exit 1
+mkdir -p bench
+
+for layout in flat morton chunked; do
+  case $layout in
+    flat) flags="-DDLA_FLAT_LATTICE -DDLA_GRID_SIZE=$GRID" ;;
+    morton) flags="-DDLA_MORTON_LATTICE -DDLA_GRID_SIZE=$GRID" ;;
+    chunked) flags="-DDLA_GRID_SIZE=$GRID" ;;
+  esac
+  make dla-batch CXX="$CXX" CPPFLAGS="$flags" > bench/build-$layout.log 2>&1 || { echo "build failed, see bench/build-$layout.log"; exit 1; }
+  mv dla-batch bench/dla-batch-$layout
+done
+
+printf "%10s %10s %10s %10s\n" endNum layout seconds same
+for n in $SIZES; do
+  for layout in flat morton chunked; do
+    rm -f bench/$layout-$n.csv  # (dla-batch appends)
+    start=$(date +%s.%N)
+    bench/dla-batch-$layout $n $PROB $SEED 3 bench/$layout-$n.csv --every $((n / 10)) $OPTIONS > /dev/null 2>&1
+    end=$(date +%s.%N)
+    same=yes
+    cmp -s bench/flat-$n.csv bench/$layout-$n.csv || same=NO
+    printf "%10s %10s %10.2f %10s\n" $n $layout $(awk "BEGIN { print $end - $start }") $same
+  done
+done
@@ -113,33 +113,31 @@ void automateRun(DLASystem* sys, int N_runs) {
 
     double prob = sys->getProbability();
 
-    for (int j = 0; j < endNum; j++) {
-      for (int i = 0; i < N_runs; i++) {
-
-          // random seed
-          int s = rand(); 
-          cout << "Size: "<< j << " Iteration: " << i+1 << " Seed:" << s << "Prob: " << prob << endl;
-          sys->setSeed(s);
-          sys->setEndNum(j);
-          sys->setRunning();
-          glutTimerFunc(0, drawFuncs::update, 0);
-          sys->setFast();
-
-          while (sys->Update() == 0) {
-            // Do nothing, just wait for update
-          }
-          
-          // Get results
-          int count = sys->getNumParticles();
-          int radius = sys->getClusterRadius();
-          // Print and exit
-          // sys->printocsv(count, radius, prob);
-          cout << "end system" << endl;
-
-          // Reset the system
-          sys->Reset();
-        
-      }
+    // one run per iteration grows the cluster once up to endNum and writes the results
+    // at every checkpoint size on the way (1, 2, 3, ...), instead of regrowing it for each size
+    sys->setCheckpoints(1, 1);
+
+    for (int i = 0; i < N_runs; i++) {
+
+        // random seed
+        int s = rand(); 
+        cout << "Size: "<< endNum << " Iteration: " << i+1 << " Seed:" << s << "Prob: " << prob << endl;
+        sys->setSeed(s);
+        sys->setEndNum(endNum);
+        sys->setRunning();
+        glutTimerFunc(0, drawFuncs::update, 0);
+        sys->setFast();
+
+        // (checkStop() pauses the system if the cluster reaches the edge of the grid)
+        while (sys->running && sys->Update() == 0) {
+          // Do nothing, just wait for update
+        }
+
+        cout << "end system" << endl;
+
+        // Reset the system
+        sys->Reset();
+      
     }
     cout << "Automated run complete" << endl;
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <stddef.h>
+
+// the fixed lattice of FlatLattice (size^Dim sites, origin in the middle, 4 bits per site:
+// occupied (8) plus the number of occupied neighbours), but shared by many threads at once
+// the size is set at run time, so one build can grow clusters of any size
+// a site becomes occupied with an atomic test-and-set of its flag (fetch_or, which cannot fail
+// spuriously like a compare-and-swap loop), so of two walkers that stick to the same site at the
+// same time exactly one wins; the neighbours' counts are then raised with atomic adds
+// (16 sites share a word, a count never carries into the next site, so the adds do not disturb them)
+template <int Dim>
+class AtomicLattice {
+  private:
+    int size;
+    size_t numWords;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;  // 16 sites per word
+
+    // linear index of a position
+    size_t index(const int pos[]) const {
+      size_t idx = pos[0] + size / 2;
+      for (int d = 1; d < Dim; d++)
+        idx = idx*size + (pos[d] + size / 2);
+      return idx;
+    }
+
+  public:
+    // a site's state is occupied + (number of occupied neighbours)
+    static const int occupied = 8;
+
+    // constructor, all sites start empty
+    AtomicLattice(int set_size) : size(set_size) {
+      size_t sites = 1;
+      for (int d = 0; d < Dim; d++)
+        sites *= size;
+      numWords = (sites + 15) / 16;
+      words.reset(new std::atomic<uint64_t>[numWords]);
+      for (size_t i = 0; i < numWords; i++)
+        words[i].store(0, std::memory_order_relaxed);
+    }
+
+    // coordinates run from -reach to reach-1
+    int reach() const {
+      return size / 2;
+    }
+
+    // read a site's state: occupied (or not) plus the number of occupied neighbours
+    // (another thread may change it straight afterwards)
+    int state(const int pos[]) const {
+      size_t idx = index(pos);
+      return (int)((words[idx >> 4].load(std::memory_order_relaxed) >> ((idx & 15) * 4)) & 15);
+    }
+
+    // make a site occupied, returns false if it already was (another walker got there first)
+    // the site must not be on the edge of the lattice
+    bool occupy(const int pos[]) {
+      size_t idx = index(pos);
+      uint64_t flag = (uint64_t)8 << ((idx & 15) * 4);
+      if (words[idx >> 4].fetch_or(flag, std::memory_order_acq_rel) & flag)
+        return false;
+      size_t step = 1;
+      for (int d = 0; d < Dim; d++) {
+        size_t up = idx + step, down = idx - step;
+        words[up >> 4].fetch_add((uint64_t)1 << ((up & 15) * 4), std::memory_order_relaxed);
+        words[down >> 4].fetch_add((uint64_t)1 << ((down & 15) * 4), std::memory_order_relaxed);
+        step *= size;
+      }
+      return true;
+    }
+
+    // memory used by the lattice (in bytes)
+    size_t bytes() const {
+      return numWords * sizeof(uint64_t);
+    }
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a pool of threads for many small batches of work: run(n, work) calls work(t, i) for i = 0..n-1,
+// each thread takes the next i as soon as it is free, and run() returns once all of them are done
+// the threads sleep between batches, so a batch costs a wakeup instead of starting threads
+// (the calling thread is thread 0 and works as well)
+class BatchPool {
+  private:
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable start;
+    std::condition_variable done;
+    int generation;  // counts the batches, a thread works once for every new value
+    int busy;        // threads still working on the batch
+    bool quit;
+
+    std::function<void(int, int)> job;
+    int numJobs;
+    std::atomic<int> next;
+
+    void work(int t) {
+      int i;
+      while ((i = next.fetch_add(1)) < numJobs)
+        job(t, i);
+    }
+
+    void loop(int t) {
+      int seen = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> l(lock);
+          start.wait(l, [&] { return quit || generation != seen; });
+          if (quit)
+            return;
+          seen = generation;
+        }
+        work(t);
+        std::lock_guard<std::mutex> l(lock);
+        if (--busy == 0)
+          done.notify_one();
+      }
+    }
+
+  public:
+    // constructor, size threads (including the calling one), at least one
+    BatchPool(int size) : generation(0), busy(0), quit(false), numJobs(0), next(0) {
+      for (int t = 1; t < size; t++)
+        threads.push_back(std::thread(&BatchPool::loop, this, t));
+    }
+
+    ~BatchPool() {
+      {
+        std::lock_guard<std::mutex> l(lock);
+        quit = true;
+      }
+      start.notify_all();
+      for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    }
+
+    BatchPool(const BatchPool &) = delete;
+    BatchPool &operator=(const BatchPool &) = delete;
+
+    int size() const {
+      return (int)threads.size() + 1;
+    }
+
+    // call work(t, i) for i = 0..n-1 on the threads of the pool (t is the thread, 0 <= t < size())
+    void run(int n, std::function<void(int, int)> work) {
+      job = work;
+      numJobs = n;
+      next.store(0);
+      {
+        std::lock_guard<std::mutex> l(lock);
+        busy = (int)threads.size();
+        generation++;
+      }
+      start.notify_all();
+      this->work(0);
+      std::unique_lock<std::mutex> l(lock);
+      done.wait(l, [&] { return busy == 0; });
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+// stores one bit (occupied or empty) for every site of a size^Dim lattice (a square or a cube)
+// the bits are kept in one contiguous block, in 3D site (i,j,k) has index (i*size + j)*size + k
+// so 400^3 sites need 8 MB instead of the 256 MB used by an int***
+// with Bits > 1 every site holds a small number (0 to 2^Bits-1) instead, Bits has to divide 64
+template <int Dim, int Bits = 1>
+class BitGrid {
+  private:
+    static_assert(64 % Bits == 0, "a site must not straddle two words");
+    static const int perWord = 64 / Bits;
+    static const uint64_t siteMask = (Bits == 64) ? ~(uint64_t)0 : ((uint64_t)1 << Bits) - 1;
+
+    size_t size;
+    std::vector<uint64_t> words;  // 64/Bits sites per word
+
+  public:
+    // constructor, all sites start empty
+    BitGrid(size_t set_size) : size(set_size) {
+      size_t sites = 1;
+      for (int d = 0; d < Dim; d++)
+        sites *= size;
+      words.assign((sites + perWord - 1) / perWord, 0);
+    }
+
+    // linear index of a site, each coordinate should be 0 <= site[d] < size
+    size_t index(const int site[]) const {
+      size_t idx = site[0];
+      for (int d = 1; d < Dim; d++)
+        idx = idx*size + site[d];
+      return idx;
+    }
+
+    // how much the linear index changes when coordinate d goes up by one
+    size_t stride(int d) const {
+      size_t s = 1;
+      for (int e = d + 1; e < Dim; e++)
+        s *= size;
+      return s;
+    }
+
+    // read a site: returns 0 or 1 (0 to 2^Bits-1)
+    int get(size_t idx) const {
+      return (int)((words[idx / perWord] >> (idx % perWord * Bits)) & siteMask);
+    }
+
+    // write a site, val should be 0 or 1 (0 to 2^Bits-1), no branches
+    void set(size_t idx, int val) {
+      int shift = idx % perWord * Bits;
+      uint64_t &w = words[idx / perWord];
+      w = (w & ~(siteMask << shift)) | ((uint64_t)val << shift);
+    }
+
+    // add delta to a site (the result must stay in 0 to 2^Bits-1, nothing carries into the next site)
+    void add(size_t idx, int delta) {
+      words[idx / perWord] += (uint64_t)(int64_t)delta << (idx % perWord * Bits);
+    }
+
+    // set every site to empty
+    void clear() {
+      words.assign(words.size(), 0);
+    }
+
+    // memory used by the bits (in bytes)
+    size_t bytes() const {
+      return words.size() * sizeof(uint64_t);
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <math.h>
+
+// the cluster sizes at which a growing cluster should be measured, so one run up to endNum
+// gives the radius (and fractal dimension) at every size of a sweep, instead of regrowing
+// a new cluster for each size
+// the schedule is either linear (first, first+every, first+2*every, ...),
+// log-spaced (first, then each size about factor times the previous one), or off
+// usage: cp.setLinear(500, 200); ... if (cp.reached(n)) print the results for size n
+class Checkpoints {
+  private:
+    int first;
+    int every;      // step of a linear schedule (0 if not linear)
+    double factor;  // ratio of a log-spaced schedule (0 if not log-spaced)
+    int next;       // the next size to report
+    int last;       // the last size that was reported (0 if none yet)
+
+  public:
+    // constructor, the schedule starts off
+    Checkpoints() : first(1), every(0), factor(0.0) { restart(); }
+
+    // report at first, first+every, first+2*every, ...
+    void setLinear(int set_first, int set_every) {
+      first = set_first < 1 ? 1 : set_first;
+      every = set_every < 1 ? 1 : set_every;
+      factor = 0.0;
+      restart();
+    }
+
+    // report at first, then at sizes growing by (at least) factor each time
+    void setLogSpaced(int set_first, double set_factor) {
+      first = set_first < 1 ? 1 : set_first;
+      every = 0;
+      factor = set_factor;
+      restart();
+    }
+
+    // never report
+    void setOff() {
+      every = 0;
+      factor = 0.0;
+      restart();
+    }
+
+    bool isOn() const {
+      return every > 0 || factor > 1.0;
+    }
+
+    // start the schedule again (for a new cluster)
+    void restart() {
+      next = first;
+      last = 0;
+    }
+
+    int getLast() const {
+      return last;
+    }
+
+    // the cluster has grown to n particles: true if n should be reported
+    // (sizes are never reported twice, and a size that is skipped over is reported late)
+    bool reached(int n) {
+      if (!isOn() || n < next)
+        return false;
+      last = n;
+      while (next <= n) {
+        if (every > 0)
+          next += every;
+        else {
+          int grown = (int)ceil(next * factor);
+          next = grown > next ? grown : next + 1;
+        }
+      }
+      return true;
+    }
+};
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include <stddef.h>
+
+// an unbounded lattice, stored as chunks of Edge^Dim sites (32^3 = 16 KB in 3D, 64^2 = 2 KB in 2D)
+// the chunks live in a hash map keyed by chunk coordinate and are only allocated when a site
+// in them is set, so the memory follows the cluster instead of the killCircle
+// reading a site in a chunk that was never allocated returns 0 without allocating it
+// the chunks that were looked up recently are remembered in a small direct-mapped table
+// (including the ones that are not allocated): a walker stays near a few chunks for many hops,
+// so most reads cost a multiply, a comparison and a shift instead of a hash map lookup
+// like FlatLattice, every site holds 4 bits: whether it is occupied (8) plus how many of its neighbours are
+template <int Dim, int Edge = (Dim == 2 ? 64 : 32)>
+class ChunkLattice {
+  private:
+    static constexpr int log2(int n) { return n <= 1 ? 0 : 1 + log2(n / 2); }
+    static const int shift = log2(Edge);  // chunk coordinate = coordinate >> shift
+    static_assert(Edge == (1 << shift), "the chunk edge must be a power of two");
+
+    static constexpr size_t power(size_t n, int p) { return p == 0 ? 1 : n * power(n, p - 1); }
+    static const size_t chunkWords = (power(Edge, Dim) + 15) / 16;  // 16 sites per word
+
+    // the chunk coordinates are packed into one 64 bit key, keyBits each (with an offset, so they are positive)
+    static const int keyBits = 64 / Dim < 21 ? 64 / Dim : 21;
+    static const uint64_t keyMask = ((uint64_t)1 << keyBits) - 1;
+    static const uint64_t keyOffset = (uint64_t)1 << (keyBits - 1);
+
+    static const size_t absent = (size_t)-1;
+    static const uint64_t noKey = ~(uint64_t)0;  // no chunk has this key
+
+    std::unordered_map<uint64_t, size_t> chunks;  // chunk key -> first word of the chunk in words
+    std::vector<uint64_t> words;
+
+    // recently looked up chunks (absent if it has not been allocated)
+    struct Recent {
+      uint64_t key;
+      size_t chunk;
+    };
+    static const int recentBits = 10;
+    mutable std::vector<Recent> recent;
+
+    static size_t recentSlot(uint64_t k) {
+      return (size_t)((k * 0x9E3779B97F4A7C15ULL) >> (64 - recentBits));
+    }
+
+    static uint64_t key(const int pos[]) {
+      uint64_t k = 0;
+      for (int d = 0; d < Dim; d++)
+        k = (k << keyBits) | ((uint64_t)((pos[d] >> shift) + (int64_t)keyOffset) & keyMask);
+      return k;
+    }
+
+    // index of a site inside its chunk
+    static size_t local(const int pos[]) {
+      size_t l = 0;
+      for (int d = 0; d < Dim; d++)
+        l = (l << shift) | (size_t)(pos[d] & (Edge - 1));
+      return l;
+    }
+
+    // first word of the chunk with key k, or absent (remembered in table)
+    size_t find(uint64_t k, std::vector<Recent> &table) const {
+      Recent &r = table[recentSlot(k)];
+      if (r.key != k) {
+        typename std::unordered_map<uint64_t, size_t>::const_iterator it = chunks.find(k);
+        r.key = k;
+        r.chunk = (it == chunks.end()) ? absent : it->second;
+      }
+      return r.chunk;
+    }
+    size_t find(uint64_t k) const {
+      return find(k, recent);
+    }
+
+    // the state of the site at pos in the chunk that starts at word chunk (or absent)
+    int stateIn(size_t chunk, const int pos[]) const {
+      if (chunk == absent)
+        return 0;
+      size_t l = local(pos);
+      return (int)((words[chunk + (l >> 4)] >> ((l & 15) * 4)) & 15);
+    }
+
+    // first word of the chunk with key k, allocated (all empty) if it is not there yet
+    size_t findOrAllocate(uint64_t k) {
+      size_t chunk = find(k);
+      if (chunk == absent) {
+        chunk = words.size();
+        words.resize(chunk + chunkWords, 0);
+        chunks[k] = chunk;
+        recent[recentSlot(k)].chunk = chunk;
+      }
+      return chunk;
+    }
+
+    // add delta to the site with index l in the chunk that starts at word chunk
+    void addLocal(size_t chunk, size_t l, int delta) {
+      words[chunk + (l >> 4)] += (uint64_t)(int64_t)delta << ((l & 15) * 4);
+    }
+
+  public:
+    // coordinates run from -reach to reach-1
+    static const int reach = (int)(keyOffset * Edge < 0x40000000 ? keyOffset * Edge : 0x40000000);
+    // clear() only costs as much as the chunks that were allocated
+    static const bool sparse = true;
+    static const char *name() { return "chunked"; }
+
+    // a site's state is occupied + (number of occupied neighbours)
+    static const int occupied = 8;
+
+    ChunkLattice() : recent((size_t)1 << recentBits, Recent{noKey, absent}) {}
+
+    // read a site: returns 0 or 1
+    int get(const int pos[]) const {
+      return state(pos) >> 3;
+    }
+
+    // read a site's state: occupied (or not) plus the number of occupied neighbours
+    int state(const int pos[]) const {
+      return stateIn(find(key(pos)), pos);
+    }
+
+    // read-only access for one of several threads: the table of recent chunks is the only thing
+    // a read changes, so every reader has its own, and any number of readers can read at once
+    // as long as nobody writes to the lattice (reset() the reader after a write, a chunk that
+    // was absent may have been allocated)
+    class Reader {
+      private:
+        const ChunkLattice &lattice;
+        std::vector<Recent> recent;
+
+      public:
+        Reader(const ChunkLattice &set_lattice)
+          : lattice(set_lattice), recent((size_t)1 << recentBits, Recent{noKey, absent}) {}
+        void reset() {
+          recent.assign(recent.size(), Recent{noKey, absent});
+        }
+        int state(const int pos[]) {
+          return lattice.stateIn(lattice.find(key(pos), recent), pos);
+        }
+    };
+
+    // write a site, val should be 0 or 1 (the neighbours' counts are kept up to date, which may
+    // allocate the chunks next to the site's own)
+    void set(const int pos[], int val) {
+      uint64_t k = key(pos);
+      size_t chunk = find(k);
+      if (chunk == absent) {
+        if (val == 0)
+          return;
+        chunk = findOrAllocate(k);
+      }
+      size_t l = local(pos);
+      uint64_t &w = words[chunk + (l >> 4)];
+      int bit = (l & 15) * 4;
+      if ((int)((w >> (bit + 3)) & 1) == val)
+        return;
+      w ^= (uint64_t)8 << bit;
+
+      int delta = val ? 1 : -1;
+      bool interior = true;
+      for (int d = 0; d < Dim; d++) {
+        int c = pos[d] & (Edge - 1);
+        if (c == 0 || c == Edge - 1)
+          interior = false;
+      }
+      // inside a chunk all the neighbours are in the same chunk
+      if (interior) {
+        for (int d = 0; d < Dim; d++) {
+          size_t step = (size_t)1 << (shift * (Dim - 1 - d));
+          addLocal(chunk, l + step, delta);
+          addLocal(chunk, l - step, delta);
+        }
+      }
+      else {
+        for (int i = 0; i < 2*Dim; i++) {
+          int n[Dim];
+          for (int d = 0; d < Dim; d++)
+            n[d] = pos[d];
+          n[i >> 1] += (i & 1) ? -1 : 1;
+          addLocal(findOrAllocate(key(n)), local(n), delta);
+        }
+      }
+    }
+
+    // set every site to empty (the memory of the chunks is kept for the next run)
+    void clear() {
+      chunks.clear();
+      words.clear();
+      recent.assign(recent.size(), Recent{noKey, absent});
+    }
+
+    // number of chunks in use
+    size_t numChunks() const {
+      return chunks.size();
+    }
+
+    // memory used by the chunks and (roughly) the hash map (in bytes)
+    size_t bytes() const {
+      return words.size() * sizeof(uint64_t)
+        + chunks.size() * (sizeof(uint64_t) + sizeof(size_t) + 2 * sizeof(void*))
+        + chunks.bucket_count() * sizeof(void*);
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+// which walkers of a speculative batch (up to 64, one bit each) read a lattice site, kept per block of
+// Edge^Dim sites around the origin: a walker sets its bit in the block of every site it reads,
+// and once a particle sticks, the blocks of its site and its neighbours (the sites whose state it changed)
+// say which walkers may have read something that is no longer true
+// blocks make this cheaper than one word per site, at the price of some walkers that only came close
+// (see DLAEngine::growSpeculative)
+// mark() can be called by many threads at once, readers() and clear() only while nobody marks
+template <int Dim, int Edge = (Dim == 2 ? 4 : 8)>
+class ConflictMap {
+  private:
+    static constexpr int log2(int n) { return n <= 1 ? 0 : 1 + log2(n / 2); }
+    static const int shift = log2(Edge);  // block coordinate = coordinate >> shift
+    static_assert(Edge == (1 << shift), "the block edge must be a power of two");
+
+    int reach;     // coordinates run from -reach to reach-1
+    int numEdge;   // blocks along each edge
+    size_t numBlocks;
+    std::unique_ptr<std::atomic<uint64_t>[]> blocks;
+
+  public:
+    ConflictMap() : reach(0), numEdge(0), numBlocks(0) {}
+
+    // make sure coordinates from -r to r-1 are covered (this clears the map if it has to grow)
+    void cover(int r) {
+      if (r <= reach)
+        return;
+      reach = ((r + r / 2) >> shift << shift) + Edge;  // room to grow, whole blocks
+      numEdge = 2 * reach >> shift;
+      numBlocks = 1;
+      for (int d = 0; d < Dim; d++)
+        numBlocks *= numEdge;
+      blocks.reset(new std::atomic<uint64_t>[numBlocks]);
+      for (size_t i = 0; i < numBlocks; i++)
+        blocks[i].store(0, std::memory_order_relaxed);
+    }
+
+    // the block of a site (which must be covered)
+    size_t block(const int pos[]) const {
+      size_t b = (pos[0] + reach) >> shift;
+      for (int d = 1; d < Dim; d++)
+        b = b*numEdge + ((pos[d] + reach) >> shift);
+      return b;
+    }
+
+    // set the bit of a walker in the block of pos, returns the block if the bit was not set yet
+    // (so the caller can keep a list of what to clear) and -1 if it was
+    ptrdiff_t mark(const int pos[], uint64_t bit) {
+      size_t b = block(pos);
+      if (blocks[b].load(std::memory_order_relaxed) & bit)
+        return -1;
+      blocks[b].fetch_or(bit, std::memory_order_relaxed);
+      return (ptrdiff_t)b;
+    }
+
+    // the walkers that read a site whose state changes when pos becomes occupied
+    uint64_t readers(const int pos[]) const {
+      uint64_t bits = blocks[block(pos)].load(std::memory_order_relaxed);
+      for (int i = 0; i < 2*Dim; i++) {
+        int n[Dim];
+        for (int d = 0; d < Dim; d++)
+          n[d] = pos[d];
+        n[i >> 1] += (i & 1) ? -1 : 1;
+        bits |= blocks[block(n)].load(std::memory_order_relaxed);
+      }
+      return bits;
+    }
+
+    // empty the blocks in the list
+    void clear(const std::vector<size_t> &list) {
+      for (size_t i = 0; i < list.size(); i++)
+        blocks[list[i]].store(0, std::memory_order_relaxed);
+    }
+
+    // memory used by the blocks (in bytes)
+    size_t bytes() const {
+      return numBlocks * sizeof(uint64_t);
+    }
+};
@@ -0,0 +1,1238 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <stdio.h>
+#include <vector>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <string>
+#include <type_traits>
+#include <stdint.h>
+
+#include "Log.h"
+#include "ResultWriter.h"
+#include "Checkpoints.h"
+#include "ParticleStore.h"
+#include "LaunchShell.h"
+#include "FlatLattice.h"
+#include "MortonLattice.h"
+#include "ChunkLattice.h"
+#include "DistanceMap.h"
+#include "OccupancyPyramid.h"
+#include "ConflictMap.h"
+#include "BatchPool.h"
+#include "rnd.h"
+
+using namespace std;
+
+// models with Model::trace log every call and step of the walk in debug builds (see Log.h)
+#define DLA_MODEL_TRACE(msg) do { if (Model::trace) LOG_TRACE(msg); } while (0)
+
+// the DLA algorithm itself, shared by the 2D, 3D and gravitational models
+// Dim is the dimension of the lattice (2 or 3), so the loops over coordinates and neighbours
+// have a fixed length and are unrolled by the compiler
+// Model says what is different about each model (see DLASystem.h in each directory):
+//   Model::gridSize          number of sites along each edge of the window that the distance map and
+//                            the pyramid cover (and of the whole lattice with -DDLA_FLAT_LATTICE or -DDLA_MORTON_LATTICE)
+//   Model::endNum, Model::prob, Model::outputFile(), Model::checkpointEvery   default settings
+//   Model::firstPassage      can walkers be sent back to the addCircle (only for unbiased walks)
+//   Model::hasGravity        does G mean anything for this model
+//   Model::summaryAtEnd      finishRun() writes a results line for the finished cluster
+//   Model::trace             log every call and step of the walk in debug builds
+//   Model::hop(rgen, pos, G) which neighbour a walker at pos hops to: 0..2*Dim-1 is +x, -x, +y, -y, +z, -z
+//   Model::record(out, sys, n, pos, radius)   write the results line for a stuck particle
+template <int Dim, class Model>
+class DLAEngine {
+  public:
+    static const int dim = Dim;  // two or three dimensions
+    typedef Model Policy;
+
+  protected:
+    // size of grid
+    static const int gridSize = Model::gridSize;
+
+    // the lattice: by default made of chunks that are allocated as the cluster grows, so there is
+    // no edge to stop at, -DDLA_FLAT_LATTICE gives the old fixed gridSize^Dim block of bits
+    // and -DDLA_MORTON_LATTICE the same block in Morton order
+#if defined(DLA_MORTON_LATTICE)
+    typedef MortonLattice<Dim, gridSize> Lattice;
+#elif defined(DLA_FLAT_LATTICE)
+    typedef FlatLattice<Dim, gridSize> Lattice;
+#else
+    typedef ChunkLattice<Dim> Lattice;
+#endif
+    // stores whether each site is occupied and how many of its neighbours are (4 bits per site),
+    // the counts are kept up to date on every stick so a hop needs one read to know if it touches the cluster
+    Lattice grid;
+
+    // a lattice coordinate is at most Lattice::reach from the origin, so small lattices get 16 bit coordinates
+    typedef typename std::conditional<(Lattice::reach < 32767), int16_t, int32_t>::type Coord;
+
+    // the particles of the cluster, in the order they stuck (the first one is the seed at the origin)
+    // reserved up to endNum, so a run never allocates
+    ParticleStore<Dim, Coord> cluster;
+    // number of particles, including the active walker
+    int numParticles;
+
+    // clear the particle list
+    void clearParticles();
+
+    // empty the grid (and the distance map and pyramid) before the next run
+    void clearSites();
+
+    // size of cluster
+    double clusterRadius;
+    // these are related to the DLA algorithm
+    double addCircle;
+    double killCircle;
+
+    // the same as squared integer distances, so the tests on every hop need no sqrt:
+    // a site at squared distance r2 from the origin is outside the killCircle exactly when r2 > killCircle2
+    int64_t clusterRadius2;
+    int64_t killCircle2;
+    int64_t radiusJumpR2;  // walkers further out than this can make a radius jump (see radiusJumps)
+
+    // neighbours of a site, in the order of the hop directions:
+    // direction i changes coordinate i/2, by +1 for even i and -1 for odd i
+    static const int numNeighbours = 2*Dim;
+
+    // the active (walking) particle is kept apart from the cluster, as integer coordinates,
+    // it is only added to the cluster (and written into the grid) once it sticks
+    int walkerPos[Dim];
+    int64_t walkerR2;  // its squared distance from the origin, a hop changes it by 2x+1 (one add)
+
+    // the distance map and the pyramid only cover the gridSize^Dim sites around the origin (the window),
+    // window coordinates run from 0 to gridSize-1
+    static void windowSite(const int pos[], int site[]) {
+      for (int d = 0; d < Dim; d++)
+        site[d] = pos[d] + gridSize / 2;
+    }
+    static bool inWindow(const int site[]) {
+      for (int d = 0; d < Dim; d++)
+        if (site[d] < 0 || site[d] >= gridSize)
+          return false;
+      return true;
+    }
+
+    // remove the walker (it has left the killCircle)
+    void killWalker();
+
+    // first-passage relaunch: instead of deleting walkers that leave the killCircle,
+    // put them back on the addCircle where they would (eventually) have returned to it
+    int firstPassage;
+
+    // the walker has just left the killCircle at pos: kill it, or send it back to the addCircle
+    void leaveKillCircle(const int pos[]);
+
+    // distance from each site to the cluster, NULL unless distance map jumps are switched on
+    // (it costs one byte per site, so it is only allocated when needed)
+    DistanceMap<Dim> *distMap;
+    static const int distanceCap = 16;  // distances are only tracked up to this value
+
+    // radius jumps: every occupied site is within clusterRadius of the origin, so a walker at distance r
+    // has no occupied site within r-clusterRadius and can jump as it would with the distance map
+    // this needs no memory and works anywhere on the lattice, not just in the window
+    // (only for unbiased walks, like first-passage relaunch)
+    int radiusJumps;
+
+    // "any site occupied nearby" blocks of size 2,4,...,2^pyramidLevels, NULL unless pyramid jumps are switched on
+    OccupancyPyramid<Dim> *pyramid;
+    static const int pyramidLevels = 7;
+
+    // mark a lattice position as part of the cluster (grid, distance map and pyramid)
+    void markOccupied(const int pos[]);
+
+    // the lattice sites that new walkers start from, rebuilt when the addCircle grows past its radius
+    LaunchShell<Dim, Coord> launchShell;
+    void updateLaunchShell();
+
+    // the window draws only part of the grid, viewSize controls how much...
+    double viewSize;
+    double drawScale;
+
+    // random number generator, class name is rnd, instance is rgen
+    // every system has its own generator, so runs are reproducible from the seed
+    rnd rgen;
+    int seed;
+
+    // walker streams: every walker draws from its own stream of random numbers, set from the seed and
+    // the number of walkers launched before it, so what a walker does depends only on the cluster
+    // it walks in and not on how many numbers the walkers before it used
+    // (a different stream of numbers, so the clusters differ from the default ones for the same seed)
+    int walkerStreams;
+    int64_t launches;  // walkers launched in this run (including the ones that left the killCircle)
+
+    // speculative growth (see growSpeculative): what a walker did, walked against the cluster
+    // as it was at the start of its batch
+    struct Speculation {
+      int outcome;   // stuck (at pos), gone (left the killCircle at squared distance r2) or replay
+      int pos[Dim];
+      int64_t r2;
+      int exact;     // it depended on the exact cluster radius (radius jumps, first-passage returns)
+    };
+    static const int stuck = 1, gone = 0, replay = -1;
+    // the lattice as a speculative walker sees it (for step()): every site it reads is marked in reads
+    // with the walker's bit, and the blocks it marks first are listed in marked
+    struct MarkingReader {
+      static const int occupied = Lattice::occupied;
+      typename Lattice::Reader &reader;
+      ConflictMap<Dim> &reads;
+      std::vector<size_t> &marked;
+      uint64_t bit;
+
+      int state(const int pos[]) {
+        ptrdiff_t block = reads.mark(pos, bit);
+        if (block >= 0)
+          marked.push_back((size_t)block);
+        return reader.state(pos);
+      }
+    };
+    // walk the walker with number launch (using no state but the lattice, through reader, which
+    // it marks in reads with bit)
+    void speculateWalker(int64_t launch, uint64_t bit, typename Lattice::Reader &reader,
+                         ConflictMap<Dim> &reads, std::vector<size_t> &marked, Speculation &s) const;
+    int64_t speculated;  // walkers of this run that were committed as they were walked in their batch
+    int64_t replayed;    // and the ones that had to be walked again
+
+    // output file (not used at the moment)
+    ofstream logfile;
+
+    // csv file that the results are appended to
+    string outputFile;
+
+    // writes the results to outputFile in the background, opened on first use
+    ResultWriter results;
+    int openResults();
+
+    // the cluster sizes at which results are written
+    Checkpoints checkpoints;
+
+    // ask the window to redraw (does nothing unless a window is attached)
+    virtual void postRedisplay() {}
+
+    // number of particles at which the simulation will stop
+    // (the value is set in constructor)
+    int endNum;
+
+    // the values of these variables are set in the constructor
+    double prob;
+    uint64_t stickThreshold;  // prob as an integer threshold for rgen.bernoulli()
+    double logFail;           // log(1-prob) for rgen.geometric()
+
+    // geometric sticking: instead of one random number per sticking trial, the walker draws
+    // how many trials it will fail before it sticks (once, at its first contact) and counts them off
+    // the trials are independent, so this is the same process with far fewer random numbers at small prob
+    // (but a different stream of them, so the clusters differ from the default ones for the same seed)
+    int geometricSticking;
+    int64_t failuresLeft;  // trials the walker fails before it sticks, -1 until its first contact
+    double G;  // gravitational constant (passed to Model::hop, see Model::hasGravity)
+
+    // the jumps assume an unbiased walk, a hop that G pulls towards the cluster cannot be skipped
+    bool biasedWalk() const { return Model::hasGravity && G != 0.0; }
+
+  public:
+    // update the system: if there is an active particle then move it,
+    // else create a new particle (on the adding circle)
+    // new: 0 - if not finished, 1 - if finished
+    int Update();
+
+    // is the simulation running (1) or paused (0) ?
+    int running;
+
+    // slowNotFast is +1 for slow running, 0 for fast
+    int slowNotFast;
+
+    // lastParticleIsActive is +1 if there is an active particle in the system, otherwise 0
+    int lastParticleIsActive;
+
+    // constructor
+    DLAEngine();
+    // destructor
+    virtual ~DLAEngine();
+
+    DLAEngine(const DLAEngine &) = delete;
+    DLAEngine &operator=(const DLAEngine &) = delete;
+
+    // delete all particles and reset
+    void Reset();
+
+    // this sets the seed for the random numbers
+    void setSeed(int s) { seed = s; rgen.setSeed(s); }
+
+    // switch walker streams on (1) or off (0), see walkerStreams
+    void setWalkerStreams(int on) { walkerStreams = on; }
+
+    // switch distance map jumps on (1) or off (0): a walker at distance d from the cluster
+    // jumps to a random point at distance d-2, instead of taking single lattice steps
+    void setDistanceMapJumps(int on);
+
+    // switch pyramid jumps on (1) or off (0): a walker with no cluster site within 2^k
+    // (checked on blocks of 2^k sites) jumps to a random point at distance 2^k-1
+    void setPyramidJumps(int on);
+
+    // switch radius jumps on (1) or off (0), see radiusJumps
+    void setRadiusJumps(int on) { radiusJumps = Model::firstPassage ? on : 0; }
+
+    // switch geometric sticking on (1) or off (0), see geometricSticking
+    void setGeometricSticking(int on) { geometricSticking = on; }
+
+    // switch first-passage relaunch on (1) or off (0), models with a biased walk never use it
+    void setFirstPassage(int on) { firstPassage = Model::firstPassage ? on : 0; }
+
+    // check whether we should stop (the cluster has reached the edge of the lattice,
+    // only possible with the flat lattice or an absurdly big cluster)
+    int checkStop();
+
+    // stop/start the algorithm
+    void setRunning() { if ( checkStop()==0 ) running = 1; }
+    void pauseRunning() { running = 0; }
+    // set whether it runs fast or slow
+    void setSlow() { slowNotFast = 1; }
+    void setFast() { slowNotFast = 0; }
+    void setSuperFast() { slowNotFast = -1; }
+
+    // set which part of the grid is visible on the screen
+    // basically the screen shows co-ordinates -vv < x < vv
+    // where vv is the input value
+    void setViewSize(double vv) { viewSize = vv; drawScale = 2.0/viewSize; }
+
+    // if the killcircle is almost as big as the view then increase the view
+    void updateViewSize();
+
+    // set the view to be the approx size of the addCircle
+    void viewAddCircle();
+
+    // if a particle that stuck at squared distance r2 is outside the cluster radius
+    // then set clusterRadius to be its distance
+    void updateClusterRadius(int64_t r2);
+
+    // return the distance of a given point from the origin
+    static double distanceFromOrigin(const int pos[]) {
+      // (in double, the lattice is big enough for the squares to overflow an int)
+      if constexpr (Dim == 2)
+        return sqrt( (double)pos[0]*pos[0] + (double)pos[1]*pos[1] );
+      else
+        return sqrt( (double)pos[0]*pos[0] + (double)pos[1]*pos[1] + (double)pos[2]*pos[2] );
+    }
+
+    // the largest squared integer distance n with sqrt(n) <= r
+    static int64_t lastInside(double r) {
+      int64_t n = (int64_t)(r * r);
+      while (sqrt((double)(n + 1)) <= r)
+        n++;
+      while (n > 0 && sqrt((double)n) > r)
+        n--;
+      return n;
+    }
+    // squared distance of a lattice position from the origin
+    static int64_t squaredRadius(const int pos[]) {
+      int64_t r2 = 0;
+      for (int d = 0; d < Dim; d++)
+        r2 += (int64_t)pos[d] * pos[d];
+      return r2;
+    }
+
+    // set v to a random unit vector from rgen, uniform on the circle (2D) or sphere (3D)
+    static void randomDirection(rnd &rgen, double v[]);
+
+    static constexpr double addRatio = 1.2;   // how much bigger the addCircle should be, compared to cluster radius
+    static constexpr double killRatio = 1.7;  // how much bigger is the killCircle, compared to the addCircle
+
+    // the addCircle and killCircle for a cluster of radius r (they never shrink), returns 1 if they grew
+    static int growCircles(double r, double &addCircle, double &killCircle);
+
+    // how far a walker at squared distance r2 can jump (less than 2 means it hops), jump is what the
+    // distance map or the pyramid allow, radius jumps are made beyond radiusJumpR2 (noRadiusJumps for none)
+    static const int64_t noRadiusJumps = INT64_MAX;
+    static int jumpLength(int jump, int64_t r2, int64_t radiusJumpR2, double clusterRadius, double killCircle);
+
+    // one move of a walker at pos (r2 is its squared distance from the origin): a jump of length jump
+    // if it is 2 or more, otherwise a hop from Model::hop onto a site that sites (a lattice, or anything
+    // with state() and occupied) says is not occupied
+    // pos and r2 are updated, it returns the number of occupied neighbours of the new site (0 after a jump),
+    // leftKillCircle if the walker is now outside the killCircle or blocked if it stayed where it was
+    static const int leftKillCircle = -1, blocked = -2;
+    template <class Sites>
+    static int step(rnd &rgen, double G, int jump, int64_t killCircle2, Sites &sites, int pos[], int64_t &r2);
+
+    // set whether there is an active particle in the system or not
+    void setParticleActive()   { lastParticleIsActive = 1; }
+    void setParticleInactive() { lastParticleIsActive = 0; }
+
+    // add a particle at pos
+    void addParticle(const double pos[]);
+    // add a particle at a random point on the addCircle
+    void addParticleOnAddCircle();
+
+    // this attempts to move the last particle in the List to a random neighbour
+    // if the neighbour is occupied then nothing happens
+    // the function also checks if the moving particle should stick.
+    void moveLastParticle();
+
+    // check whether the last particle should stick, contacts is its number of occupied neighbours
+    // it sticks with probability prob for every occupied neighbour
+    int checkStick(int contacts);
+    // the same for any walker, with its own random numbers and failures left, threshold is prob as
+    // for rnd::bernoulli(), or with geometric sticking logFail is log(1-prob) (see geometricSticking)
+    static int stickTrials(rnd &r, int contacts, int64_t &failures, uint64_t threshold, double logFail, int geometric);
+
+    // the walker has stuck where it is: add it to the cluster and write the results
+    void stickWalker();
+
+    // where a walker that left the killCircle at pos first comes back to the addCircle (radius a), from r
+    // returns 0 if it never comes back (see leaveKillCircle)
+    static int firstReturn(rnd &r, const int pos[], double a, int newpos[]);
+
+    // grow the cluster to endNum like Update() does (with walker streams), but walk batches of walkers
+    // on threads threads at once, see the comment at the function
+    // the cluster, the results and everything else are exactly those of the serial run
+    void growSpeculative(int threads, int batch);
+    int64_t getSpeculated() const { return speculated; }
+    int64_t getReplayed() const { return replayed; }
+
+    // the run has ended: write the results line for the finished cluster (if the model has one
+    // and the last checkpoint was not the finished cluster already)
+    void finishRun();
+
+    // Get num particles
+    int getNumParticles() const {
+        return numParticles-1;
+    }
+
+    // Get cluster radius
+    int getClusterRadius() const {
+        return clusterRadius;
+    }
+
+    // Get cluster radius
+    int getEndNum() const {
+      return endNum;
+    }
+
+    void setEndNum(int end) {
+      endNum = end;
+      cluster.reserve(endNum);
+    }
+
+    double getProbability() const {
+      return prob;
+    }
+
+    void setProbability(double p) {
+      prob = p;
+      stickThreshold = rnd::threshold(prob);
+      logFail = log(1.0 - prob);
+    }
+
+    double getG() const {
+      return G;
+    }
+
+    void setG(double set_G) {
+      G = set_G;
+    }
+
+    // set the csv file that the results are written to
+    void setOutputFile(const string &file) {
+      outputFile = file;
+    }
+
+    // write results at cluster sizes first, first+every, first+2*every, ...
+    void setCheckpoints(int first, int every) { checkpoints.setLinear(first, every); }
+    // the same at log-spaced sizes: first, then each about factor times the previous one
+    void setLogCheckpoints(int first, double factor) { checkpoints.setLogSpaced(first, factor); }
+    void setCheckpointsOff() { checkpoints.setOff(); }
+    // the last cluster size that was written (0 if none)
+    int getLastCheckpoint() const { return checkpoints.getLast(); }
+
+    // wait until all results written so far are in the output file
+    void flushResults() { results.flush(); }
+
+    // keep the results in memory instead of writing them to the output file,
+    // takeResults() then hands over everything since the last call (eg one whole run)
+    void holdResults() { results.hold(); }
+    string takeResults() { return results.takeHeld(); }
+};
+
+
+// this function gets called every step,
+//   if there is an active particle then it gets moved,
+//   if not then add a particle
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::Update() {
+	DLA_MODEL_TRACE("Update get's called");
+
+	bool end = 0; //allows me to know when simulation stopped
+
+	if (lastParticleIsActive == 1)
+		moveLastParticle();
+	else if (numParticles < endNum) {
+		addParticleOnAddCircle();
+		setParticleActive();
+	}
+	else if (numParticles == endNum)
+	{
+		end = 1;
+	}
+	if (lastParticleIsActive == 0 || slowNotFast == 1)
+		postRedisplay(); //Tell GLUT that the display has changed
+
+	return end;
+}
+
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::clearParticles() {
+	DLA_MODEL_TRACE("clearParticles get's called");
+	// clear the particle list (it keeps its memory for the next run)
+	cluster.clear();
+	numParticles = 0;
+}
+
+// remove any existing particles and setup initial condition
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::Reset() {
+	DLA_MODEL_TRACE("Reset get's called");
+	// stop running
+	running = 0;
+
+	// make sure the results of the last run are on disk
+	results.flush();
+
+	// set the grid to zero (this needs the particle list, so it comes first)
+	clearSites();
+	clearParticles();
+	checkpoints.restart();
+
+	lastParticleIsActive = 0;
+
+	// setup initial condition and parameters
+	addCircle = 10;
+	killCircle = 2.0*addCircle;
+	killCircle2 = lastInside(killCircle);
+	clusterRadius = 0.0;
+	clusterRadius2 = 0;
+	radiusJumpR2 = lastInside(clusterRadius + 4);
+	launches = 0;
+	speculated = 0;
+	replayed = 0;
+	// add a single particle at the origin
+	double pos[Dim] = { 0.0 };
+	addParticle(pos);
+
+	// set the view
+	int InitialViewSize = 40;
+	setViewSize(InitialViewSize);
+
+}
+
+// only the sites of the cluster are occupied (the walker is never written into the grid),
+// so for a small cluster it is much quicker to clear just those than the whole grid:
+// 400^3 sites are 32 MB of lattice and 64 MB of distance map, a cluster of 1000 is a few thousand writes
+// each structure falls back to a full clear once clearing site by site would cost more
+// (one scattered write is counted as 64 bytes of a full clear, about one cache line, and
+// clearing a lattice site also updates the counts of its neighbours)
+// the chunked lattice just drops its chunks, which costs as little as the cluster
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::clearSites() {
+	size_t n = cluster.size();
+	int pos[Dim], site[Dim];
+
+	if (Lattice::sparse || n * (numNeighbours + 1) * 64 >= grid.bytes())
+		grid.clear();
+	else {
+		for (size_t i = 0; i < n; i++) {
+			cluster.get(i, pos);
+			grid.set(pos, 0);
+		}
+	}
+
+	if (distMap != NULL) {
+		// the entries around a site are mostly contiguous rows, so count them as one byte each
+		if (n * distMap->stampSize() >= distMap->bytes())
+			distMap->clear();
+		else {
+			for (size_t i = 0; i < n; i++) {
+				for (int d = 0; d < Dim; d++)
+					site[d] = cluster.get(i, d) + gridSize / 2;
+				distMap->resetAround(site);
+			}
+		}
+	}
+
+	if (pyramid != NULL) {
+		if (n * pyramid->stampSize() * 64 >= pyramid->bytes())
+			pyramid->clear();
+		else {
+			for (size_t i = 0; i < n; i++) {
+				for (int d = 0; d < Dim; d++)
+					site[d] = cluster.get(i, d) + gridSize / 2;
+				pyramid->resetAround(site);
+			}
+		}
+	}
+}
+
+// check if the cluster is big enough and we should stop:
+// to be safe, we need the killCircle to be at least 2 less than the edge of the lattice
+// (for the chunked lattice the edge is millions of sites away)
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::checkStop() {
+	DLA_MODEL_TRACE("checkStop get's called");
+	if (killCircle + 2 >= Lattice::reach) {
+		pauseRunning();
+		LOG_INFO("STOP");
+		postRedisplay(); // update display
+		return 1;
+	}
+	else return 0;
+}
+
+// add a particle to the system at a specific position
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::addParticle(const double pos[]) {
+	DLA_MODEL_TRACE("addParticle get's called");
+	// pos coordinates should be -reach <= x < reach (see Lattice)
+	int ipos[Dim];
+	for (int d = 0; d < Dim; d++)
+		ipos[d] = (int)pos[d];
+	// add it to the end of the list
+	cluster.add(ipos);
+	numParticles++;
+
+	markOccupied(ipos);
+}
+
+// a site has joined the cluster
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::markOccupied(const int pos[]) {
+	grid.set(pos, 1);
+	// sites just outside the window can still lower distances inside it, the
+	// distance map and the pyramid skip the parts that are outside
+	int site[Dim];
+	windowSite(pos, site);
+	if (distMap != NULL)
+		distMap->addSite(site);
+	if (pyramid != NULL)
+		pyramid->addSite(site);
+}
+
+// switch the distance map on or off
+// when it is switched on, the existing cluster is written into it
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::setDistanceMapJumps(int on) {
+	if (on == 1 && distMap == NULL) {
+		distMap = new DistanceMap<Dim>(gridSize, distanceCap);
+		for (size_t i = 0; i < cluster.size(); i++) {
+			int site[Dim];
+			for (int d = 0; d < Dim; d++)
+				site[d] = cluster.get(i, d) + gridSize / 2;
+			distMap->addSite(site);
+		}
+	}
+	else if (on == 0 && distMap != NULL) {
+		delete distMap;
+		distMap = NULL;
+	}
+}
+
+// switch the occupancy pyramid on or off
+// when it is switched on, the existing cluster is written into it
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::setPyramidJumps(int on) {
+	if (on == 1 && pyramid == NULL) {
+		pyramid = new OccupancyPyramid<Dim>(gridSize, pyramidLevels);
+		for (size_t i = 0; i < cluster.size(); i++) {
+			int site[Dim];
+			for (int d = 0; d < Dim; d++)
+				site[d] = cluster.get(i, d) + gridSize / 2;
+			pyramid->addSite(site);
+		}
+	}
+	else if (on == 0 && pyramid != NULL) {
+		delete pyramid;
+		pyramid = NULL;
+	}
+}
+
+// add a particle to the system at a random position on the addCircle (rounded up to a whole number of sites):
+// one random site of the launch shell, every site of the shell is equally likely, so the launches are
+// uniform around the circle (2D) or over the sphere (3D) as far as the lattice allows, with no trig per launch
+// if we hit an occupied site then we do nothing except print a message
+// (this should never happen)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::addParticleOnAddCircle() {
+	DLA_MODEL_TRACE("addParticleOnAddCircle get's called");
+	if (walkerStreams)
+		rgen.setSeed(seed, (uint64_t)launches);
+	launches++;
+	updateLaunchShell();
+	int pos[Dim];
+	launchShell.get(rgen.randomInt((int)launchShell.size()), pos);
+	if (grid.get(pos) == 0) {
+		// the walker is not added to the cluster (or the grid) until it sticks
+		numParticles++;
+		for (int d = 0; d < Dim; d++)
+			walkerPos[d] = pos[d];
+		walkerR2 = squaredRadius(walkerPos);
+		failuresLeft = -1;
+	}
+	else
+		LOG_ERROR("FAIL " << pos[0] << " " << pos[1]);
+}
+
+// rebuild the launch shell if the addCircle has grown past it
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::updateLaunchShell() {
+	int radius = (int)ceil(addCircle);
+	if (radius != launchShell.getRadius()) {
+		launchShell.build(radius);
+		LOG_DEBUG("launch shell of radius " << radius << ": " << launchShell.size() << " sites");
+	}
+}
+
+// if the view is smaller than the kill circle then increase the view area (zoom out)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::updateViewSize() {
+	DLA_MODEL_TRACE("updateViewSize get's called");
+	double mult = 1.2;
+	if (viewSize < 2.0*killCircle) {
+		setViewSize(viewSize * mult);
+	}
+}
+
+// set the view to be the size of the add circle (ie zoom in on the cluster)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::viewAddCircle() {
+	DLA_MODEL_TRACE("viewAddCircle get's called");
+	setViewSize(2.0*addCircle);  // factor of 2 is to go from radius to diameter
+}
+
+// when we add a particle to the cluster, we should update the cluster radius
+// and the sizes of the addCircle and the killCircle
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::updateClusterRadius(int64_t r2) {
+	DLA_MODEL_TRACE("updateClusterRadius get's called");
+
+	// (only a particle that makes the cluster bigger needs the sqrt)
+	if (r2 > clusterRadius2) {
+		clusterRadius2 = r2;
+		clusterRadius = sqrt((double)r2);
+		radiusJumpR2 = lastInside(clusterRadius + 4);
+		// if the addCircle is too small then update everything...
+		if (growCircles(clusterRadius, addCircle, killCircle)) {
+			killCircle2 = lastInside(killCircle);
+			updateViewSize();
+		}
+		checkStop();
+	}
+}
+
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::growCircles(double r, double &addCircle, double &killCircle) {
+	// this is how big addCircle is supposed to be:
+	//   either 20% more than cluster radius, or at least 5 bigger.
+	double check = r * addRatio;
+	if (check < r + 5)
+		check = r + 5;
+	if (addCircle >= check)
+		return 0;
+	addCircle = check;
+	killCircle = killRatio * addCircle;
+	return 1;
+}
+
+// remove the walker (it was never added to the cluster, so there is nothing to free)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::killWalker() {
+	//cout << "#deleting particle" << endl;
+	numParticles--;
+	setParticleInactive();
+}
+
+// the walker has left the killCircle: without first-passage relaunch it is deleted,
+// with it, it is put where it first comes back to the addCircle (if it does)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::leaveKillCircle(const int pos[]) {
+	int newpos[Dim];
+	if (firstPassage == 0 || !firstReturn(rgen, pos, addCircle, newpos)) {
+		killWalker();  // it escapes: a new walker is launched instead
+		return;
+	}
+
+	// the addCircle is always clear of the cluster, but be careful anyway
+	if (grid.get(newpos) == 1) {
+		killWalker();
+		return;
+	}
+	for (int d = 0; d < Dim; d++)
+		walkerPos[d] = newpos[d];
+	walkerR2 = squaredRadius(walkerPos);
+}
+
+// where does a walker that has left the killCircle (at distance R) first come back to the addCircle (radius a)?
+// 2D: a random walk always comes back, so the walker is never deleted. The return point has the
+//   Poisson kernel density (R^2 - a^2) / (2 pi |x - y|^2), for which tan(angle/2) is Cauchy
+//   distributed with scale (R - a)/(R + a)
+// 3D: the walker returns with probability a/R, otherwise it escapes to infinity. The return point
+//   has density (R^2 - a^2) / |x - y|^3 (the harmonic measure seen from x), which we sample exactly:
+//   the cosine t of the angle between x and y has a cdf that can be inverted by hand,
+//   and the angle around x is uniform
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::firstReturn(rnd &rgen, const int pos[], double a, int newpos[]) {
+	double R = distanceFromOrigin(pos);
+
+	if constexpr (Dim == 2) {
+		double angle = atan2((double)pos[1], (double)pos[0])
+			+ 2.0 * atan((R - a) / (R + a) * tan(M_PI * (rgen.random01() - 0.5)));
+		newpos[0] = (int)lround(a * cos(angle));
+		newpos[1] = (int)lround(a * sin(angle));
+	}
+	else {
+		if (rgen.random01() * R >= a)
+			return 0;
+
+		double u = rgen.random01();
+		double s = 1.0/(R + a) + u * (1.0/(R - a) - 1.0/(R + a));
+		double t = (R*R + a*a - 1.0/(s*s)) / (2.0*a*R);
+		if (t > 1.0) t = 1.0;
+		if (t < -1.0) t = -1.0;
+
+		// unit vector along x, and two unit vectors perpendicular to it
+		double e0[3] = { pos[0]/R, pos[1]/R, pos[2]/R };
+		double helper[3] = { 1.0, 0.0, 0.0 };
+		if (fabs(e0[0]) > 0.9) {
+			helper[0] = 0.0;
+			helper[1] = 1.0;
+		}
+		double e1[3] = { e0[1]*helper[2] - e0[2]*helper[1], e0[2]*helper[0] - e0[0]*helper[2], e0[0]*helper[1] - e0[1]*helper[0] };
+		double n1 = sqrt(e1[0]*e1[0] + e1[1]*e1[1] + e1[2]*e1[2]);
+		for (int d = 0; d < 3; d++)
+			e1[d] /= n1;
+		double e2[3] = { e0[1]*e1[2] - e0[2]*e1[1], e0[2]*e1[0] - e0[0]*e1[2], e0[0]*e1[1] - e0[1]*e1[0] };
+
+		// uniform angle around x, drawn as a point on the unit circle (no trig functions)
+		double c, sn, r2;
+		do {
+			c = 2.0 * rgen.random01() - 1.0;
+			sn = 2.0 * rgen.random01() - 1.0;
+			r2 = c*c + sn*sn;
+		} while (r2 >= 1.0 || r2 == 0.0);
+		double norm = sqrt((1.0 - t*t) / r2);
+
+		for (int d = 0; d < 3; d++)
+			newpos[d] = (int)lround(a * (t*e0[d] + norm*(c*e1[d] + sn*e2[d])));
+	}
+	return 1;
+}
+
+// uniform random direction (Marsaglia's method in 3D, no trig functions)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::randomDirection(rnd &rgen, double v[]) {
+	double u1, u2, s;
+	do {
+		u1 = 2.0 * rgen.random01() - 1.0;
+		u2 = 2.0 * rgen.random01() - 1.0;
+		s = u1*u1 + u2*u2;
+	} while (s >= 1.0 || (Dim == 2 && s == 0.0));
+	if constexpr (Dim == 2) {
+		double f = 1.0 / sqrt(s);
+		v[0] = u1 * f;
+		v[1] = u2 * f;
+	}
+	else {
+		double f = 2.0 * sqrt(1.0 - s);
+		v[0] = u1 * f;
+		v[1] = u2 * f;
+		v[2] = 1.0 - 2.0 * s;
+	}
+}
+
+// the radius jump, and the room left inside the killCircle that no jump may reach past
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::jumpLength(int jump, int64_t r2, int64_t radiusJumpR2, double clusterRadius, double killCircle) {
+	// outside the cluster radius the nearest occupied site is at least r-clusterRadius away
+	// (one comparison per hop, the sqrt is only needed once the walker is 4 or more outside it)
+	double r = -1.0;
+	if (r2 > radiusJumpR2) {
+		r = sqrt((double)r2);
+		int gap = (int)(r - clusterRadius) - 2;
+		if (gap > jump)
+			jump = gap;
+	}
+	// a hopping walker is killed as soon as it leaves the killCircle, so the jump
+	// must not reach past it either (or walkers would survive that should not)
+	if (jump > 0) {
+		if (r < 0.0)
+			r = sqrt((double)r2);
+		int room = (int)(killCircle - r);
+		if (jump > room)
+			jump = room;
+	}
+	return jump;
+}
+
+// a random walk that starts in the middle of an empty ball leaves it at a (close to) uniform
+// point on its surface, so a jump puts the walker there in one go
+// (the caller has to make sure that no site within jump+1 of the walker is in the cluster)
+// a hop is made on pos itself and taken back if the site is occupied: copying pos to a new position
+// first reads all of pos right after the last hop wrote one coordinate of it, which the processor
+// cannot forward from its store buffer, and makes the walk about twice as slow
+template <int Dim, class Model>
+template <class Sites>
+int DLAEngine<Dim, Model>::step(rnd &rgen, double G, int jump, int64_t killCircle2, Sites &sites, int pos[], int64_t &r2) {
+	if (jump >= 2) {
+		double v[Dim];
+		randomDirection(rgen, v);
+		for (int d = 0; d < Dim; d++)
+			pos[d] += (int)lround(jump * v[d]);
+		r2 = squaredRadius(pos);
+		return r2 > killCircle2 ? leftKillCircle : 0;
+	}
+
+	int rr = Model::hop(rgen, pos, G);  // pick a random number in the range 0 to 2*Dim-1, which direction do we hop?
+	int axis = rr >> 1;
+	int step = (rr & 1) ? -1 : 1;
+	// (x+step)^2 = x^2 + 2*step*x + 1
+	int64_t newR2 = r2 + 2 * step * (int64_t)pos[axis] + 1;
+	pos[axis] += step;
+	if (newR2 > killCircle2) {
+		r2 = newR2;
+		return leftKillCircle;
+	}
+
+	// check if destination is empty (the same read says how many occupied neighbours it has)
+	int state = sites.state(pos);
+	if (state >= Sites::occupied) {
+		pos[axis] -= step;
+		return blocked;
+	}
+	r2 = newR2;
+	return state;
+}
+
+// make a random move of the walker
+// the walker only lives in walkerPos: a hop changes one coordinate
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::moveLastParticle() {
+	DLA_MODEL_TRACE("moveLastParticle get's called");
+	// far from the cluster we can jump instead of hopping:
+	// if the nearest occupied site is d away, rounding the jump to the lattice moves the walker
+	// at most sqrt(3)/2 further, so a jump of d-2 can never land on or next to the cluster
+	// (outside the window that the distance map and the pyramid cover only radius jumps are possible,
+	// and none of them for a walk biased by G)
+	int jump = 0;
+	int site[Dim];
+	windowSite(walkerPos, site);
+	bool inside = (distMap != NULL || pyramid != NULL) && !biasedWalk() && inWindow(site);
+	if (distMap != NULL && inside) {
+		int d = distMap->get(site);
+		if (d >= 4)
+			jump = d - 2;
+	}
+	// a clear pyramid level k means every occupied site is at least 2^k+1 away
+	if (pyramid != NULL && inside) {
+		int level = pyramid->emptyLevel(site);
+		if (level >= 2 && (1 << level) - 1 > jump)
+			jump = (1 << level) - 1;
+	}
+	jump = jumpLength(jump, walkerR2, radiusJumps ? radiusJumpR2 : noRadiusJumps, clusterRadius, killCircle);
+
+	int state = step(rgen, G, jump, killCircle2, grid, walkerPos, walkerR2);
+	if (state == leftKillCircle)
+		leaveKillCircle(walkerPos);
+	else if (state == blocked) {
+		// if we get to here then we are trying to move to an occupied site
+		// (this should never happen as long as the sticking probability is 1.0)
+		LOG_DEBUG("reject");
+		LOG_DEBUG(walkerPos[0] << " " << walkerPos[1]);
+	}
+	// check if we stick
+	else if (state > 0 && checkStick(state))
+		stickWalker();
+}
+
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::stickWalker() {
+	//cout << "stick" << endl;
+	cluster.add(walkerPos);
+	markOccupied(walkerPos);  // the stuck particle now occupies its grid site
+	double pos[Dim];
+	for (int d = 0; d < Dim; d++)
+		pos[d] = walkerPos[d];
+	int n_p = numParticles-1;
+	double radius = clusterRadius;  // the radius before this particle
+	setParticleInactive();  // make the particle inactive (stuck)
+	updateClusterRadius(walkerR2);  // update the cluster radius, addCircle, etc.
+
+	// one results line at each checkpoint size
+	if (checkpoints.reached(n_p) && openResults()) {
+		LOG_DEBUG("saving results");
+		Model::record(results, *this, n_p, pos, radius);
+	}
+
+	if (numParticles % 100 == 0 && logfile.is_open()) {
+		logfile << numParticles << " " << clusterRadius << endl;
+	}
+
+	DLA_MODEL_TRACE("working:" << walkerPos[0] << "," << walkerPos[1] << "," << walkerPos[Dim - 1]);  // (the models that trace are 3D)
+}
+
+// speculative growth: walker streams fix every walker's random numbers by its launch number, so a walker
+// can be walked before the ones launched ahead of it have finished, against the cluster as it was at the
+// start of its batch: batch walkers are walked at once on the threads, then committed one by one in launch
+// order, exactly as Update() would have run them. A walk is still the serial one unless an earlier walker
+// of the batch stuck next to a site it read (the conflict map tells, by blocks of sites), or the cluster
+// radius changed and it depended on it: only those walkers are walked again, serially, by the Update() code
+// the result is bit for bit the cluster (and the results) of the serial run with walker streams and the
+// same seed, for any number of threads and any batch size, which only change how fast it is
+// distance map and pyramid jumps are not supported: their maps change with the cluster as well
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::growSpeculative(int threads, int batch) {
+	if (distMap != NULL || pyramid != NULL) {
+		LOG_ERROR("speculative growth does not work with distance map or pyramid jumps");
+		return;
+	}
+	walkerStreams = 1;
+	if (batch > 64)
+		batch = 64;  // one bit per walker in the conflict map
+	if (batch < 1)
+		batch = 1;
+
+	BatchPool pool(threads);
+	std::vector<typename Lattice::Reader> readers(pool.size(), typename Lattice::Reader(grid));
+	std::vector<std::vector<size_t> > marked(pool.size());  // the blocks each thread marked, to clear them
+	std::vector<Speculation> spec(batch);
+	ConflictMap<Dim> reads;
+
+	while (running && numParticles < endNum && lastParticleIsActive == 0) {
+		// walk the next batch against the cluster as it is now (nobody writes to it meanwhile)
+		updateLaunchShell();
+		reads.cover((int)fmax(killCircle, clusterRadius + batch) + 2);
+		for (size_t t = 0; t < readers.size(); t++)
+			readers[t].reset();
+		int64_t first = launches;
+		int64_t batchR2 = clusterRadius2;
+		int shellRadius = launchShell.getRadius();
+		pool.run(batch, [&](int t, int i) {
+			speculateWalker(first + i, (uint64_t)1 << i, readers[t], reads, marked[t], spec[i]);
+		});
+
+		// commit them in launch order, the walkers that read a site next to one that has stuck since
+		// are in conflicts
+		uint64_t conflicts = 0;
+		for (int i = 0; i < batch && running && numParticles < endNum; i++) {
+			const Speculation &s = spec[i];
+			bool valid = s.outcome != replay && !((conflicts >> i) & 1);
+			// with a bigger cluster radius, a walker that did not depend on it is still valid if it started
+			// on the same shell and (if it left the killCircle) would still have left the bigger one
+			if (valid && clusterRadius2 != batchR2)
+				valid = !s.exact && (int)ceil(addCircle) == shellRadius && (s.outcome == stuck || s.r2 > killCircle2);
+
+			size_t size = cluster.size();
+			if (valid) {
+				speculated++;
+				launches++;
+				if (s.outcome == stuck) {
+					numParticles++;
+					for (int d = 0; d < Dim; d++)
+						walkerPos[d] = s.pos[d];
+					walkerR2 = s.r2;
+					stickWalker();
+				}
+			}
+			else {
+				// walk it again on the cluster as it is now, the way Update() does
+				replayed++;
+				addParticleOnAddCircle();
+				setParticleActive();
+				while (lastParticleIsActive == 1 && running)
+					moveLastParticle();
+			}
+			if (cluster.size() > size && i + 1 < batch) {
+				int pos[Dim];
+				cluster.get(cluster.size() - 1, pos);
+				conflicts |= reads.readers(pos);
+			}
+		}
+
+		for (size_t t = 0; t < marked.size(); t++) {
+			reads.clear(marked[t]);
+			marked[t].clear();
+		}
+	}
+	LOG_INFO("speculative growth: " << speculated << " walkers committed as walked, " << replayed << " walked again");
+}
+
+// one walker of a speculative batch, addParticleOnAddCircle() and then the step() of moveLastParticle()
+// until it sticks, with the walker's own random numbers (walker streams) and without distance map or pyramid jumps
+// every lattice site it reads is marked in reads (and the new blocks listed in marked)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::speculateWalker(int64_t launch, uint64_t bit, typename Lattice::Reader &reader,
+                                            ConflictMap<Dim> &reads, std::vector<size_t> &marked, Speculation &s) const {
+	rnd walk;
+	walk.setSeed(seed, (uint64_t)launch);
+	MarkingReader sites = { reader, reads, marked, bit };
+	int pos[Dim];
+
+	launchShell.get(walk.randomInt((int)launchShell.size()), pos);
+	s.exact = 0;
+	if (sites.state(pos) >= Lattice::occupied) {
+		s.outcome = replay;  // (this should never happen, let the serial code deal with it)
+		return;
+	}
+	int64_t r2 = squaredRadius(pos);
+	int64_t failures = -1;
+	// (in locals: the compiler cannot tell that marking a read leaves the members alone, and would
+	// load them again on every hop)
+	const int64_t jumpR2 = radiusJumps ? radiusJumpR2 : noRadiusJumps, kill2 = killCircle2;
+
+	while (true) {
+		if (r2 > jumpR2)
+			s.exact = 1;
+		int jump = jumpLength(0, r2, jumpR2, clusterRadius, killCircle);
+		int state = step(walk, G, jump, kill2, sites, pos, r2);
+		if (state != leftKillCircle) {
+			if (state > 0 && stickTrials(walk, state, failures, stickThreshold, logFail, geometricSticking)) {
+				s.outcome = stuck;
+				for (int d = 0; d < Dim; d++)
+					s.pos[d] = pos[d];
+				s.r2 = r2;
+				return;
+			}
+			continue;
+		}
+
+		// it has left the killCircle at pos, as in leaveKillCircle()
+		s.outcome = gone;
+		s.r2 = r2;
+		if (firstPassage == 0)
+			return;
+		s.exact = 1;
+		int back[Dim];
+		if (!firstReturn(walk, pos, addCircle, back) || sites.state(back) >= Lattice::occupied)
+			return;
+		for (int d = 0; d < Dim; d++)
+			pos[d] = back[d];
+		r2 = squaredRadius(pos);
+	}
+}
+
+// the finished cluster gets a results line too (for models that write one line per run)
+template <int Dim, class Model>
+void DLAEngine<Dim, Model>::finishRun() {
+	if constexpr (Model::summaryAtEnd) {
+		int count = getNumParticles();
+		if (checkpoints.getLast() != count && openResults()) {
+			double pos[Dim];
+			for (int d = 0; d < Dim; d++)
+				pos[d] = cluster.get(cluster.size() - 1, d);
+			Model::record(results, *this, count, pos, clusterRadius);
+		}
+	}
+}
+
+// make sure the results writer has outputFile open
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::openResults() {
+	if (results.isHolding() || (results.isOpen() && results.getPath() == outputFile))
+		return 1;
+	if (!results.open(outputFile)) {
+		// Failed to open the file
+		LOG_ERROR("Error: Unable to open the file for writing.");
+		return 0;
+	}
+	return 1;
+}
+
+// check if the last particle should stick (to a neighbour)
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::checkStick(int contacts) {
+	DLA_MODEL_TRACE("checkStick get's called");
+	int result = stickTrials(rgen, contacts, failuresLeft, stickThreshold, logFail, geometricSticking);
+	if (result) {
+		LOG_DEBUG("Stick: Particle " << numParticles);
+	} else if (geometricSticking) {
+		LOG_DEBUG("Not Stick: Particle " << numParticles << ", " << failuresLeft << " failures left");
+	} else {
+		LOG_DEBUG("Not Stick: Particle " << numParticles << ": " << contacts << " trials");
+	}
+	return result;
+}
+
+template <int Dim, class Model>
+int DLAEngine<Dim, Model>::stickTrials(rnd &r, int contacts, int64_t &failures, uint64_t threshold, double logFail, int geometric) {
+	if (geometric) {
+		if (failures < 0)
+			failures = r.geometric(logFail);
+		if (failures < contacts)
+			return 1;
+		failures -= contacts;
+		return 0;
+	}
+
+	int result = 0;
+	// one trial for every occupied neighbour (the grid keeps count of them)
+	for (int i = 0; i < contacts; i++) {
+		// the particle sticks with probability p (one integer comparison, seeded by setSeed)
+		if (r.bernoulli(threshold))
+			result = 1;
+	}
+	return result;
+
+	/*
+	The updated algorithm now incorporates a stochastic element into the growth of the cluster.
+	Upon contact with existing particles, each new particle has a chance of adhering to the cluster,
+	determined by a specified sticking probability, p.
+	If the random ratio generated from 1 to an upper limit (m) is less than p,
+	the particle becomes part of the cluster. Otherwise, it proceeds independently,
+	following the original trajectory rules. This adjustment introduces variability into the
+	cluster's expansion,as particles may or may not attach depending on the probabilistic outcome.
+	Those that do not stick continue their movement without contributing to cluster
+	growth but still interact with existing particles according to system rules.
+	*/
+}
+
+// constructor
+template <int Dim, class Model>
+DLAEngine<Dim, Model>::DLAEngine() : numParticles(0) {
+	LOG_INFO("creating system, gridSize " << gridSize << ", lattice " << Lattice::name()
+		<< " (" << grid.bytes() / (1024*1024) << " MB)");
+	endNum = Model::endNum;
+	cluster.reserve(endNum);
+	setProbability(Model::prob);
+	geometricSticking = 0;  // one random number per sticking trial
+	failuresLeft = -1;
+	seed = 1;  // (the seed of rgen until setSeed)
+	walkerStreams = 0;  // all walkers draw from rgen in turn
+	G = 0; // gravitational constant
+	outputFile = Model::outputFile();
+	if (Model::checkpointEvery > 0)
+		checkpoints.setLinear(Model::checkpointEvery, Model::checkpointEvery);
+	distMap = NULL;  // distance map jumps are off unless switched on
+	pyramid = NULL;  // and so are pyramid jumps
+	firstPassage = 0;  // walkers that leave the killCircle are deleted
+	radiusJumps = 0;  // walkers far outside the cluster radius hop like the others
+	lastParticleIsActive = 0;
+
+	slowNotFast = 1;
+	// reset initial parameters
+	Reset();
+
+
+	// this opens a logfile, if we want to...
+	//logfile.open("opfile.txt");
+}
+
+// destructor
+template <int Dim, class Model>
+DLAEngine<Dim, Model>::~DLAEngine() {
+	// strictly we should not print inside the destructor but never mind...
+	LOG_INFO("deleting system");
+	// delete the distance map and the pyramid
+	delete distMap;
+	delete pyramid;
+
+	if (logfile.is_open())
+		logfile.close();
+}
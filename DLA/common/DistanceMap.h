@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// for every site of a size^Dim lattice, stores the distance to the nearest
+// occupied site, rounded down and capped at maxDistance (so one byte per site)
+// the sites use the same linear index as BitGrid: in 3D (i*size + j)*size + k
+// the map is updated incrementally: each new occupied site lowers the distances around it
+template <int Dim>
+class DistanceMap {
+  private:
+    int size;
+    int maxDistance;
+    std::vector<uint8_t> dist;
+
+    // all the offsets closer than maxDistance, with their (rounded down) length
+    struct Offset {
+      int delta[Dim];
+      long linear;  // the same offset as a change of the linear index
+      uint8_t d;
+    };
+    std::vector<Offset> stamp;
+
+  public:
+    // constructor, the map starts with every site at maxDistance (nothing occupied)
+    DistanceMap(int set_size, int set_maxDistance) : size(set_size), maxDistance(set_maxDistance) {
+      size_t sites = 1;
+      for (int d = 0; d < Dim; d++)
+        sites *= size;
+      dist.assign(sites, (uint8_t)maxDistance);
+
+      // run through every offset of the cube -maxDistance..maxDistance (like an odometer)
+      Offset o;
+      for (int d = 0; d < Dim; d++)
+        o.delta[d] = -maxDistance;
+      while (true) {
+        int r2 = 0;
+        o.linear = 0;
+        for (int d = 0; d < Dim; d++) {
+          r2 += o.delta[d]*o.delta[d];
+          o.linear = o.linear*size + o.delta[d];
+        }
+        int length = (int)sqrt((double)r2);
+        if (length < maxDistance) {
+          o.d = (uint8_t)length;
+          stamp.push_back(o);
+        }
+        int d = Dim - 1;
+        while (d >= 0 && o.delta[d] == maxDistance)
+          o.delta[d--] = -maxDistance;
+        if (d < 0)
+          break;
+        o.delta[d]++;
+      }
+    }
+
+    // distance (rounded down, at most maxDistance) from site idx to the nearest occupied site
+    int get(size_t idx) const {
+      return dist[idx];
+    }
+    int get(const int site[]) const {
+      size_t idx = site[0];
+      for (int d = 1; d < Dim; d++)
+        idx = idx*size + site[d];
+      return dist[idx];
+    }
+
+    int getMaxDistance() const {
+      return maxDistance;
+    }
+
+    // forget all occupied sites
+    void clear() {
+      dist.assign(dist.size(), (uint8_t)maxDistance);
+    }
+
+    // a site has become occupied: lower the distances of all sites around it
+    void addSite(const int site[]) {
+      // (site may be outside the map, as long as part of its stamp is inside)
+      long idx = 0;
+      bool inside = true;
+      for (int d = 0; d < Dim; d++) {
+        if (site[d] <= -maxDistance || site[d] >= size + maxDistance)
+          return;
+        idx = idx*size + site[d];
+        if (site[d] < maxDistance || site[d] >= size - maxDistance)
+          inside = false;
+      }
+      for (size_t n = 0; n < stamp.size(); n++) {
+        const Offset &o = stamp[n];
+        // near the edge of the lattice we have to check every offset
+        if (!inside) {
+          bool outside = false;
+          for (int d = 0; d < Dim; d++)
+            if (site[d] + o.delta[d] < 0 || site[d] + o.delta[d] >= size)
+              outside = true;
+          if (outside)
+            continue;
+        }
+        uint8_t &v = dist[idx + o.linear];
+        if (v > o.d)
+          v = o.d;
+      }
+    }
+
+    // undo addSite() for every occupied site: set the distances around site back to maxDistance
+    // (only right if it is done for all the occupied sites, as Reset does, since a distance
+    // around site may have been lowered by another occupied site too)
+    void resetAround(const int site[]) {
+      // (site may be outside the map, as long as part of its stamp is inside)
+      long idx = 0;
+      bool inside = true;
+      for (int d = 0; d < Dim; d++) {
+        if (site[d] <= -maxDistance || site[d] >= size + maxDistance)
+          return;
+        idx = idx*size + site[d];
+        if (site[d] < maxDistance || site[d] >= size - maxDistance)
+          inside = false;
+      }
+      for (size_t n = 0; n < stamp.size(); n++) {
+        const Offset &o = stamp[n];
+        if (!inside) {
+          bool outside = false;
+          for (int d = 0; d < Dim; d++)
+            if (site[d] + o.delta[d] < 0 || site[d] + o.delta[d] >= size)
+              outside = true;
+          if (outside)
+            continue;
+        }
+        dist[idx + o.linear] = (uint8_t)maxDistance;
+      }
+    }
+
+    // number of map entries that addSite() and resetAround() touch
+    size_t stampSize() const {
+      return stamp.size();
+    }
+
+    // memory used by the map (in bytes)
+    size_t bytes() const {
+      return dist.size();
+    }
+};
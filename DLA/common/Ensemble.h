@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// one simulation of an ensemble: grow a cluster of endNum particles with sticking
+// probability prob (and gravitational constant G, for the model that has one) from seed
+struct EnsembleJob {
+  int endNum;
+  double prob;
+  double G;
+  int seed;
+};
+
+// runs a list of jobs on a pool of threads
+// every thread has its own queue of jobs and takes them from the back;
+// once its queue is empty it steals from the front of the other queues, so all threads
+// stay busy until every job is done, even when some jobs take much longer than others (eg small prob)
+// usage: Ensemble e(4); e.add(job); ... e.run(work);  where work(thread, job) runs one job
+class Ensemble {
+  private:
+    struct Queue {
+      std::mutex m;
+      std::deque<EnsembleJob> jobs;
+    };
+    std::vector<Queue> queues;  // one per thread
+    int numJobs;
+    std::atomic<int> stolen;    // number of jobs that were run by another thread than they were given to
+
+    // find the next job for thread t, returns false once there are no jobs left anywhere
+    bool take(int t, EnsembleJob &job) {
+      int n = (int)queues.size();
+      {
+        Queue &q = queues[t];
+        std::lock_guard<std::mutex> lock(q.m);
+        if (!q.jobs.empty()) {
+          job = q.jobs.back();
+          q.jobs.pop_back();
+          return true;
+        }
+      }
+      for (int k = 1; k < n; k++) {
+        Queue &q = queues[(t + k) % n];
+        std::lock_guard<std::mutex> lock(q.m);
+        if (!q.jobs.empty()) {
+          job = q.jobs.front();
+          q.jobs.pop_front();
+          stolen++;
+          return true;
+        }
+      }
+      return false;
+    }
+
+  public:
+    // constructor, threads < 1 means one thread per core
+    Ensemble(int threads) : numJobs(0), stolen(0) {
+      if (threads < 1)
+        threads = (int)std::thread::hardware_concurrency();
+      if (threads < 1)
+        threads = 1;
+      queues = std::vector<Queue>(threads);
+    }
+
+    int getThreads() const {
+      return (int)queues.size();
+    }
+
+    int getNumJobs() const {
+      return numJobs;
+    }
+
+    int getStolen() const {
+      return stolen;
+    }
+
+    // add a job (the jobs are dealt out to the threads in turn)
+    void add(const EnsembleJob &job) {
+      queues[numJobs % queues.size()].jobs.push_back(job);
+      numJobs++;
+    }
+
+    // run all the jobs, work(t, job) is called on thread t (0 <= t < getThreads())
+    // and must only touch the state that belongs to thread t
+    template <class Work>
+    void run(Work work) {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < getThreads(); t++)
+        threads.push_back(std::thread([this, t, &work] {
+          EnsembleJob job;
+          while (take(t, job))
+            work(t, job);
+        }));
+      for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    }
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "BitGrid.h"
+
+// the lattice as one dense block of Size^Dim bits, with the origin in the middle
+// every coordinate must stay within -Size/2 <= x < Size/2, so the cluster has to stop growing
+// once its killCircle reaches the edge (see DLAEngine::checkStop)
+// this is the grid the models always had, build with -DDLA_FLAT_LATTICE to use it
+// every site holds 4 bits: whether it is occupied (8) plus how many of its neighbours are (0 to 2*Dim),
+// so one read tells a walker both whether it can hop there and how many sticking trials it gets
+template <int Dim, int Size>
+class FlatLattice {
+  private:
+    BitGrid<Dim, 4> sites;
+
+    // linear index of a position
+    size_t index(const int pos[]) const {
+      size_t idx = pos[0] + Size / 2;
+      for (int d = 1; d < Dim; d++)
+        idx = idx*Size + (pos[d] + Size / 2);
+      return idx;
+    }
+
+  public:
+    // coordinates run from -reach to reach-1
+    static const int reach = Size / 2;
+    // clear() costs the same however few sites are occupied
+    static const bool sparse = false;
+    static const char *name() { return "flat"; }
+
+    // a site's state is occupied + (number of occupied neighbours)
+    static const int occupied = 8;
+
+    FlatLattice() : sites(Size) {}
+
+    // read a site: returns 0 or 1
+    int get(const int pos[]) const {
+      return sites.get(index(pos)) >> 3;
+    }
+
+    // read a site's state: occupied (or not) plus the number of occupied neighbours
+    int state(const int pos[]) const {
+      return sites.get(index(pos));
+    }
+
+    // read-only access for one of several threads (see ChunkLattice::Reader), here the reads have no side effects
+    class Reader {
+      private:
+        const FlatLattice &lattice;
+
+      public:
+        Reader(const FlatLattice &set_lattice) : lattice(set_lattice) {}
+        void reset() {}
+        int state(const int pos[]) const {
+          return lattice.state(pos);
+        }
+    };
+
+    // write a site, val should be 0 or 1 (the neighbours' counts are kept up to date,
+    // so the site must not be on the edge of the lattice)
+    void set(const int pos[], int val) {
+      size_t idx = index(pos);
+      int s = sites.get(idx);
+      if ((s >> 3) == val)
+        return;
+      sites.set(idx, (s & 7) | (val << 3));
+      int delta = val ? 1 : -1;
+      size_t step = 1;
+      for (int d = 0; d < Dim; d++) {
+        sites.add(idx + step, delta);
+        sites.add(idx - step, delta);
+        step *= Size;
+      }
+    }
+
+    // set every site to empty
+    void clear() {
+      sites.clear();
+    }
+
+    // memory used by the lattice (in bytes)
+    size_t bytes() const {
+      return sites.bytes();
+    }
+};
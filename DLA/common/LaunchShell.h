@@ -0,0 +1,85 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ParticleStore.h"
+
+// every lattice site at distance radius from the origin (rounded to the nearest whole number),
+// ie radius - 1/2 <= distance < radius + 1/2, which is where new walkers are launched from
+// picking one of them with a single random number gives launches that are uniform around the
+// circle (2D) or over the sphere (3D) as far as the lattice allows, with no trig per launch
+template <int Dim, class Coord = int32_t>
+class LaunchShell {
+  private:
+    ParticleStore<Dim, Coord> sites;
+    int radius;
+
+  public:
+    LaunchShell() : radius(0) {}
+
+    // the radius the shell was built for (0 if it has not been built)
+    int getRadius() const {
+      return radius;
+    }
+
+    // collect the sites with (2 radius - 1)^2 <= 4 r^2 < (2 radius + 1)^2
+    // the first Dim-1 coordinates run through the whole square (cube) around the shell,
+    // and the last one is solved for, so this costs radius^(Dim-1) and not radius^Dim
+    void build(int set_radius) {
+      sites.clear();
+      radius = set_radius;
+      int64_t lo = (int64_t)(2*radius - 1) * (2*radius - 1);
+      int64_t hi = (int64_t)(2*radius + 1) * (2*radius + 1);
+      int pos[Dim];
+      for (int d = 0; d < Dim - 1; d++)
+        pos[d] = -radius;
+      while (true) {
+        int64_t r2 = 0;
+        for (int d = 0; d < Dim - 1; d++)
+          r2 += (int64_t)pos[d] * pos[d];
+        if (4*r2 < hi) {
+          // lo <= 4 (r2 + z^2) < hi for the last coordinate z
+          int64_t zmin2 = (lo - 4*r2 <= 0) ? 0 : (lo - 4*r2 + 3) / 4;
+          int64_t zmax2 = (hi - 1 - 4*r2) / 4;
+          int64_t zmin = (int64_t)sqrt((double)zmin2);
+          while (zmin*zmin < zmin2)
+            zmin++;
+          int64_t zmax = (int64_t)sqrt((double)zmax2);
+          while ((zmax + 1)*(zmax + 1) <= zmax2)
+            zmax++;
+          while (zmax*zmax > zmax2)
+            zmax--;
+          for (int64_t z = zmin; z <= zmax; z++) {
+            pos[Dim - 1] = (int)z;
+            sites.add(pos);
+            if (z > 0) {
+              pos[Dim - 1] = -(int)z;
+              sites.add(pos);
+            }
+          }
+        }
+        int d = Dim - 2;
+        while (d >= 0 && pos[d] == radius)
+          pos[d--] = -radius;
+        if (d < 0)
+          break;
+        pos[d]++;
+      }
+    }
+
+    size_t size() const {
+      return sites.size();
+    }
+
+    // position of site i
+    void get(size_t i, int pos[]) const {
+      sites.get(i, pos);
+    }
+
+    // memory used by the sites (in bytes)
+    size_t bytes() const {
+      return sites.bytes();
+    }
+};
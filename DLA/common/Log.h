@@ -0,0 +1,29 @@
+#pragma once
+#include <iostream>
+
+// console output with log levels that are fixed at compile time
+// a message above DLA_LOG_LEVEL sits behind an if(false), so the compiler removes it completely
+// and a release build (eg -DDLA_LOG_LEVEL=1) does no console I/O at all while walking
+//   LOG_ERROR  (1) - something went wrong
+//   LOG_INFO   (2) - once per run: system created, stopped, deleted
+//   LOG_DEBUG  (3) - once per particle: stick / not stick, saving results
+//   LOG_TRACE  (4) - every step or function call
+// usage: LOG_DEBUG("Stick: Particle " << numParticles);
+
+#define DLA_LOG_LEVEL_ERROR 1
+#define DLA_LOG_LEVEL_INFO  2
+#define DLA_LOG_LEVEL_DEBUG 3
+#define DLA_LOG_LEVEL_TRACE 4
+
+// debug builds keep everything
+#ifndef DLA_LOG_LEVEL
+#define DLA_LOG_LEVEL DLA_LOG_LEVEL_TRACE
+#endif
+
+#define DLA_LOG(level, stream, msg) \
+  do { if ((level) <= DLA_LOG_LEVEL) stream << msg << std::endl; } while (0)
+
+#define LOG_ERROR(msg) DLA_LOG(DLA_LOG_LEVEL_ERROR, std::cerr, msg)
+#define LOG_INFO(msg)  DLA_LOG(DLA_LOG_LEVEL_INFO,  std::cout, msg)
+#define LOG_DEBUG(msg) DLA_LOG(DLA_LOG_LEVEL_DEBUG, std::cout, msg)
+#define LOG_TRACE(msg) DLA_LOG(DLA_LOG_LEVEL_TRACE, std::cout, msg)
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include "BitGrid.h"
+
+// multi-resolution "is anything occupied around here" index over a size^Dim lattice
+// level k splits the lattice into blocks of 2^k sites along each edge and keeps one bit per block
+// the bit is set if the block, or any of its neighbouring blocks (26 in 3D, 8 in 2D), holds an occupied site
+// so a clear bit means no occupied site within 2^k lattice units (in every direction)
+// this is far smaller than a full distance map: in 3D all levels together need about 1/7 bit per site
+template <int Dim>
+class OccupancyPyramid {
+  private:
+    int levels;
+    std::vector<int> levelSize;  // number of blocks along each edge, for levels 1..levels
+    std::vector<BitGrid<Dim> > blocks;
+
+    // set the site's block and the neighbouring blocks to val on every level
+    void setAround(const int site[], int val) {
+      for (int level = 1; level <= levels; level++) {
+        int n = levelSize[level - 1];
+        BitGrid<Dim> &b = blocks[level - 1];
+        // run through the 3^Dim blocks around the site's block (like an odometer)
+        int centre[Dim], block[Dim];
+        for (int d = 0; d < Dim; d++) {
+          centre[d] = site[d] >> level;
+          block[d] = centre[d] - 1;
+        }
+        while (true) {
+          bool inside = true;
+          for (int d = 0; d < Dim; d++)
+            if (block[d] < 0 || block[d] >= n)
+              inside = false;
+          if (inside)
+            b.set(b.index(block), val);
+          int d = Dim - 1;
+          while (d >= 0 && block[d] == centre[d] + 1) {
+            block[d] = centre[d] - 1;
+            d--;
+          }
+          if (d < 0)
+            break;
+          block[d]++;
+        }
+      }
+    }
+
+  public:
+    // constructor, levels 1..set_levels (blocks of 2 up to 2^set_levels sites)
+    OccupancyPyramid(int size, int set_levels) : levels(set_levels) {
+      for (int k = 1; k <= levels; k++) {
+        int n = (size + (1 << k) - 1) >> k;
+        levelSize.push_back(n);
+        blocks.push_back(BitGrid<Dim>(n));
+      }
+    }
+
+    int getLevels() const {
+      return levels;
+    }
+
+    // forget all occupied sites
+    void clear() {
+      for (int k = 0; k < levels; k++)
+        blocks[k].clear();
+    }
+
+    // a site has become occupied: mark its block and the neighbouring blocks on every level
+    void addSite(const int site[]) {
+      setAround(site, 1);
+    }
+
+    // undo addSite() for every occupied site: clear the blocks around site on every level
+    // (only right if it is done for all the occupied sites, as Reset does)
+    void resetAround(const int site[]) {
+      setAround(site, 0);
+    }
+
+    // number of bits that addSite() and resetAround() touch
+    size_t stampSize() const {
+      size_t blocksAround = 1;
+      for (int d = 0; d < Dim; d++)
+        blocksAround *= 3;
+      return levels * blocksAround;
+    }
+
+    // the largest level whose bit is clear at a site, or 0 if even level 1 is set
+    // (if a level is set then all the levels above it are set too, so we stop at the first one)
+    int emptyLevel(const int site[]) const {
+      int level = 0;
+      while (level < levels) {
+        const BitGrid<Dim> &b = blocks[level];
+        int shift = level + 1;
+        int block[Dim];
+        for (int d = 0; d < Dim; d++)
+          block[d] = site[d] >> shift;
+        if (b.get(b.index(block)) == 1)
+          break;
+        level++;
+      }
+      return level;
+    }
+
+    // memory used by all levels (in bytes)
+    size_t bytes() const {
+      size_t total = 0;
+      for (int k = 0; k < levels; k++)
+        total += blocks[k].bytes();
+      return total;
+    }
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <math.h>
+#include <stdint.h>
+
+#include "AtomicLattice.h"
+#include "LaunchShell.h"
+#include "DLAEngine.h"
+#include "Log.h"
+#include "rnd.h"
+
+// grows one cluster with many walkers at once: every thread walks its own particles against
+// the shared AtomicLattice, and a walker that decides to stick claims its site atomically
+// (if another walker claimed the site first, it steps back and walks on)
+// the walk is the one of DLAEngine (hops from Model::hop with G = 0, the same addCircle and killCircle,
+// the same sticking trials, radius jumps for unbiased walks), but it is NOT serial DLA:
+//  - walkers are on the lattice at the same time, so a walker can be hit by particles that stuck
+//    after it was launched (in serial DLA the cluster only changes between walkers): this is DLA
+//    at a walker density of about threads per addCircle, the difference fades as the cluster grows
+//  - the cluster radius, and with it the addCircle and the killCircle, that a walker sees can be
+//    a few hops old, and a neighbour that stuck a moment ago may not be counted in a trial yet
+//  - walkers do not see each other: two can stand on the same site, and a walker can be left on a
+//    site that another one has just claimed (it stays there and leaves it with its next hop)
+//  - the cluster can end up to threads-1 particles bigger than endNum
+//  - the result depends on how the threads were scheduled, not just on the seed
+// bench-parallel.sh measures the deviation (cluster radius and fractal dimension against one thread)
+template <int Dim, class Model>
+class ParallelGrowth {
+  private:
+    typedef DLAEngine<Dim, Model> Engine;
+
+    AtomicLattice<Dim> grid;
+    int endNum;
+    uint64_t stickThreshold;  // prob as an integer threshold for rgen.bernoulli()
+    int radiusJumps;          // see DLAEngine::radiusJumps
+
+    std::atomic<int> numStuck;
+    std::atomic<int64_t> clusterRadius2;
+    std::atomic<int> reachedEdge;
+    std::atomic<int64_t> launched;
+
+    // the launch shell is shared, a thread that needs a bigger one builds it and puts it here
+    std::mutex shellLock;
+    std::shared_ptr<const LaunchShell<Dim> > shell;
+    std::shared_ptr<const LaunchShell<Dim> > shellFor(int radius);
+
+    void worker(int t, int seed);
+
+  public:
+    // constructor: an empty lattice of size^Dim sites (each coordinate -size/2 <= x < size/2)
+    // with the seed particle at the origin
+    ParallelGrowth(int size, int set_endNum, double prob);
+
+    // switch radius jumps on (1) or off (0), only used for unbiased walks
+    void setRadiusJumps(int on) { radiusJumps = Model::firstPassage ? on : 0; }
+
+    // grow the cluster up to endNum particles with threads walkers, thread t is seeded with seed + t
+    void grow(int threads, int seed);
+
+    // number of particles, not counting the seed (like DLAEngine::getNumParticles())
+    int getNumParticles() const { return numStuck.load() - 1; }
+    double getClusterRadius() const { return sqrt((double)clusterRadius2.load()); }
+    // did the killCircle reach the edge of the lattice before endNum
+    int getReachedEdge() const { return reachedEdge.load(); }
+    // number of walkers launched (the stuck ones and the ones that left the killCircle)
+    int64_t getLaunched() const { return launched.load(); }
+
+    // memory used by the lattice (in bytes)
+    size_t bytes() const { return grid.bytes(); }
+};
+
+
+template <int Dim, class Model>
+ParallelGrowth<Dim, Model>::ParallelGrowth(int size, int set_endNum, double prob)
+	: grid(size), endNum(set_endNum), radiusJumps(0),
+	  numStuck(1), clusterRadius2(0), reachedEdge(0), launched(0) {
+	stickThreshold = rnd::threshold(prob);
+	int origin[Dim] = { 0 };
+	grid.occupy(origin);
+}
+
+// the newest launch shell, built if it is smaller than radius
+template <int Dim, class Model>
+std::shared_ptr<const LaunchShell<Dim> > ParallelGrowth<Dim, Model>::shellFor(int radius) {
+	std::lock_guard<std::mutex> lock(shellLock);
+	if (!shell || shell->getRadius() < radius) {
+		std::shared_ptr<LaunchShell<Dim> > s(new LaunchShell<Dim>());
+		s->build(radius);
+		shell = s;
+	}
+	return shell;
+}
+
+template <int Dim, class Model>
+void ParallelGrowth<Dim, Model>::grow(int threads, int seed) {
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; t++)
+		pool.push_back(std::thread(&ParallelGrowth::worker, this, t, seed));
+	for (int t = 0; t < threads; t++)
+		pool[t].join();
+}
+
+// one thread: launch a walker, walk it until it sticks or leaves the killCircle, repeat
+// (the steps are those of DLAEngine::moveLastParticle, with the shared state read atomically)
+template <int Dim, class Model>
+void ParallelGrowth<Dim, Model>::worker(int t, int seed) {
+	rnd rgen;
+	rgen.setSeed(seed + t);
+
+	// this thread's copy of the circles, updated whenever the cluster radius changes
+	int64_t knownR2 = -1;
+	double clusterRadius = 0.0, addCircle = 10.0, killCircle = 20.0;
+	int64_t killCircle2 = 0, radiusJumpR2 = 0;
+	std::shared_ptr<const LaunchShell<Dim> > myShell;
+
+	int walkerPos[Dim];
+	int64_t walkerR2 = 0;
+	int64_t failures = -1;  // (stickTrials() only counts these with geometric sticking, which is not used here)
+	bool walking = false;
+
+	while (numStuck.load(std::memory_order_relaxed) < endNum && !reachedEdge.load(std::memory_order_relaxed)) {
+		int64_t r2 = clusterRadius2.load(std::memory_order_relaxed);
+		if (r2 != knownR2) {
+			// the same addCircle and killCircle as DLAEngine::updateClusterRadius()
+			knownR2 = r2;
+			clusterRadius = sqrt((double)r2);
+			Engine::growCircles(clusterRadius, addCircle, killCircle);
+			killCircle2 = Engine::lastInside(killCircle);
+			radiusJumpR2 = radiusJumps ? Engine::lastInside(clusterRadius + 4) : Engine::noRadiusJumps;
+			if (killCircle + 2 >= grid.reach()) {
+				reachedEdge.store(1);
+				break;
+			}
+		}
+
+		if (!walking) {
+			int radius = (int)ceil(addCircle);
+			if (!myShell || myShell->getRadius() < radius)
+				myShell = shellFor(radius);
+			myShell->get(rgen.randomInt((int)myShell->size()), walkerPos);
+			if (grid.state(walkerPos) < AtomicLattice<Dim>::occupied) {
+				walkerR2 = Engine::squaredRadius(walkerPos);
+				walking = true;
+				launched.fetch_add(1, std::memory_order_relaxed);
+			}
+			continue;
+		}
+
+		// far outside the cluster radius: jump, otherwise hop
+		int jump = Engine::jumpLength(0, walkerR2, radiusJumpR2, clusterRadius, killCircle);
+		int state = Engine::step(rgen, 0.0, jump, killCircle2, grid, walkerPos, walkerR2);
+		if (state == Engine::leftKillCircle) {
+			walking = false;  // launch a new one
+			continue;
+		}
+		if (state <= 0 || !Engine::stickTrials(rgen, state, failures, stickThreshold, 0.0, 0))
+			continue;
+
+		// claim the site, unless another walker got there first
+		if (!grid.occupy(walkerPos))
+			continue;
+		numStuck.fetch_add(1);
+		// raise the cluster radius (an atomic maximum)
+		int64_t current = clusterRadius2.load();
+		while (walkerR2 > current && !clusterRadius2.compare_exchange_weak(current, walkerR2)) {
+		}
+		walking = false;
+	}
+}
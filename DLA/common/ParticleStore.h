@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+// the lattice positions of the particles of the cluster, stored as one array per coordinate
+// (all the x, then all the y, ...) instead of one heap object per particle
+// Coord is the integer type of a coordinate, int16_t is enough for grids up to 65534 sites across
+// reserve() the final cluster size before a run and add() never allocates
+template <int Dim, class Coord = int32_t>
+class ParticleStore {
+  private:
+    std::vector<Coord> coord[Dim];
+
+  public:
+    static const int dim = Dim;  // two or three dimensions
+
+    // make room for n particles
+    void reserve(size_t n) {
+      for (int d = 0; d < Dim; d++)
+        coord[d].reserve(n);
+    }
+
+    // forget all particles (the memory is kept for the next run)
+    void clear() {
+      for (int d = 0; d < Dim; d++)
+        coord[d].clear();
+    }
+
+    // add a particle at pos
+    void add(const int pos[]) {
+      for (int d = 0; d < Dim; d++)
+        coord[d].push_back((Coord)pos[d]);
+    }
+
+    size_t size() const {
+      return coord[0].size();
+    }
+
+    // coordinate d of particle i
+    int get(size_t i, int d) const {
+      return coord[d][i];
+    }
+
+    // position of particle i
+    void get(size_t i, int pos[]) const {
+      for (int d = 0; d < Dim; d++)
+        pos[d] = coord[d][i];
+    }
+
+    // memory reserved for the particles (in bytes)
+    size_t bytes() const {
+      return Dim * coord[0].capacity() * sizeof(Coord);
+    }
+};
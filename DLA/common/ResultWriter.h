@@ -0,0 +1,169 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// appends text records to a file without slowing down the simulation:
+// the file is opened once, records are copied into a ring of large chunks,
+// and a background thread writes each chunk to disk once it is full
+// usage: writer.open("3D.csv"); writer.writef("%d,%g\n", n, r); ... writer.flush();
+class ResultWriter {
+  private:
+    static const size_t chunkSize = 1 << 16;  // bytes per chunk
+    static const int numChunks = 8;           // chunks in the ring
+
+    FILE *file;
+    std::string path;
+
+    // the ring: the simulation fills chunk head, the background thread writes chunk tail
+    std::vector<char> chunks[numChunks];
+    size_t used[numChunks];   // bytes in each chunk
+    bool ready[numChunks];    // chunk is full and waiting to be written
+    int head;
+    int tail;
+
+    std::mutex m;
+    std::condition_variable cv;
+    bool stopping;
+    std::thread worker;
+
+    // while holding, records are kept in memory instead of being written
+    bool holding;
+    std::string held;
+
+    // several writers (eg the threads of an ensemble) may append to the same file,
+    // each chunk is written and flushed under this lock so chunks never interleave
+    // (a chunk only holds whole records)
+    static std::mutex &appendLock() {
+      static std::mutex lock;
+      return lock;
+    }
+
+    // background thread: write out full chunks in order
+    void run() {
+      std::unique_lock<std::mutex> lock(m);
+      while (true) {
+        cv.wait(lock, [this] { return ready[tail] || stopping; });
+        if (!ready[tail])
+          break;  // stopping, and nothing left to write
+        int c = tail;
+        lock.unlock();
+        {
+          std::lock_guard<std::mutex> append(appendLock());
+          fwrite(chunks[c].data(), 1, used[c], file);
+          fflush(file);
+        }
+        lock.lock();
+        used[c] = 0;
+        ready[c] = false;
+        tail = (tail + 1) % numChunks;
+        cv.notify_all();
+      }
+    }
+
+    // hand the current chunk to the background thread and move on to the next one
+    // (waits if the background thread has fallen a whole ring behind)
+    void submit() {
+      std::unique_lock<std::mutex> lock(m);
+      ready[head] = true;
+      int next = (head + 1) % numChunks;
+      cv.notify_all();
+      cv.wait(lock, [this, next] { return !ready[next]; });
+      head = next;
+    }
+
+  public:
+    // constructor, nothing is opened yet
+    ResultWriter() : file(NULL), head(0), tail(0), stopping(false), holding(false) {
+      for (int c = 0; c < numChunks; c++) {
+        chunks[c].resize(chunkSize);
+        used[c] = 0;
+        ready[c] = false;
+      }
+    }
+    // destructor, everything that was written ends up in the file
+    ~ResultWriter() { close(); }
+
+    ResultWriter(const ResultWriter &) = delete;
+    ResultWriter &operator=(const ResultWriter &) = delete;
+
+    // open a file in append mode (closing any previous one), returns false if that fails
+    bool open(const std::string &set_path) {
+      close();
+      file = fopen(set_path.c_str(), "a");
+      if (file == NULL)
+        return false;
+      path = set_path;
+      stopping = false;
+      worker = std::thread(&ResultWriter::run, this);
+      return true;
+    }
+
+    bool isOpen() const { return file != NULL; }
+    const std::string &getPath() const { return path; }
+
+    // keep all records in memory from now on, so that the caller can decide when
+    // (and whether) they reach a file, eg only once a whole run has finished
+    void hold() { holding = true; }
+    bool isHolding() const { return holding; }
+    // hand over the records kept since the last call (and forget them)
+    std::string takeHeld() {
+      std::string text;
+      text.swap(held);
+      return text;
+    }
+
+    // add one record, formatted like printf (records are at most 255 characters)
+    void writef(const char *fmt, ...) {
+      char line[256];
+      va_list args;
+      va_start(args, fmt);
+      int n = vsnprintf(line, sizeof(line), fmt, args);
+      va_end(args);
+      if (n < 0)
+        return;
+      if ((size_t)n >= sizeof(line))
+        n = sizeof(line) - 1;
+      if (holding) {
+        held.append(line, n);
+        return;
+      }
+      if (used[head] + n > chunkSize)
+        submit();
+      memcpy(chunks[head].data() + used[head], line, n);
+      used[head] += n;
+    }
+
+    // wait until everything written so far is in the file
+    void flush() {
+      if (file == NULL)
+        return;
+      if (used[head] > 0)
+        submit();
+      std::unique_lock<std::mutex> lock(m);
+      cv.wait(lock, [this] { return tail == head && !ready[tail]; });
+      fflush(file);
+    }
+
+    // flush, stop the background thread and close the file
+    void close() {
+      if (file == NULL)
+        return;
+      flush();
+      {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+      }
+      cv.notify_all();
+      worker.join();
+      fclose(file);
+      file = NULL;
+      path.clear();
+    }
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <fstream>
+#include <sstream>
+
+#include "Ensemble.h"
+
+// the values of one swept parameter: from, from+step, ... up to to
+// (a single value is written "v", a range "from to step")
+struct SweepRange {
+  double from, to, step;
+
+  SweepRange(double v) : from(v), to(v), step(1.0) {}
+
+  // read "v" or "from to step", returns false if the text is not a valid range
+  bool parse(const std::string &text) {
+    std::istringstream in(text);
+    double a, b, c;
+    if (!(in >> a))
+      return false;
+    if (!(in >> b)) {
+      from = to = a;
+      step = 1.0;
+      return true;
+    }
+    if (!(in >> c) || c <= 0.0 || b < a)
+      return false;
+    from = a;
+    to = b;
+    step = c;
+    return true;
+  }
+
+  std::vector<double> values() const {
+    std::vector<double> v;
+    for (int k = 0; from + k*step <= to + 1e-9; k++)
+      v.push_back(from + k*step);
+    return v;
+  }
+};
+
+// everything that describes a sweep, read from a config file of "key = value" lines
+// (# starts a comment), for example
+//   output = sweep.csv
+//   endNum = 10000
+//   prob = 0.05 0.95 0.1
+//   runs = 3
+// the same keys can be given on the command line of dla-ensemble as --key value
+class SweepConfig {
+  public:
+    int dimension;
+    std::string output;
+    std::string journal;  // empty: no journal
+    int threads;          // 0: one per core
+    int runs;
+    int seed;             // run r uses seed+r
+    SweepRange endNum;
+    SweepRange prob;
+    SweepRange G;
+    int every;            // checkpoints, see Checkpoints.h (0: the model's default)
+    int first;
+    double factor;
+    std::vector<std::string> options;  // model options that are switched on, eg "pyramid"
+
+  private:
+    std::vector<std::string> modelOptions;  // the options this model understands
+
+    static std::string trim(const std::string &s) {
+      size_t a = s.find_first_not_of(" \t\r");
+      if (a == std::string::npos)
+        return "";
+      size_t b = s.find_last_not_of(" \t\r");
+      return s.substr(a, b - a + 1);
+    }
+
+  public:
+    // constructor, set_modelOptions are the on/off options of this model (eg "first-passage")
+    SweepConfig(int set_dimension, const std::vector<std::string> &set_modelOptions)
+      : dimension(set_dimension), threads(0), runs(1), seed(1), endNum(1000), prob(1.0), G(0.0),
+        every(0), first(0), factor(0.0), modelOptions(set_modelOptions) {}
+
+    bool hasOption(const std::string &name) const {
+      for (size_t i = 0; i < options.size(); i++)
+        if (options[i] == name)
+          return true;
+      return false;
+    }
+
+    // set one key, returns false (and explains why in error) if the key or value is not valid
+    bool set(const std::string &key, const std::string &value, std::string &error) {
+      bool ok = true;
+      if (key == "dimension")
+        ok = atoi(value.c_str()) == dimension;
+      else if (key == "output")
+        output = value;
+      else if (key == "journal")
+        journal = value;
+      else if (key == "threads")
+        threads = atoi(value.c_str());
+      else if (key == "runs")
+        ok = (runs = atoi(value.c_str())) > 0;
+      else if (key == "seed")
+        seed = atoi(value.c_str());
+      else if (key == "endNum")
+        ok = endNum.parse(value) && endNum.from >= 1;
+      else if (key == "prob")
+        ok = prob.parse(value) && prob.from > 0.0 && prob.to <= 1.0;
+      else if (key == "G")
+        ok = G.parse(value);
+      else if (key == "every")
+        ok = (every = atoi(value.c_str())) > 0;
+      else if (key == "first")
+        ok = (first = atoi(value.c_str())) > 0;
+      else if (key == "log-spaced")
+        ok = (factor = atof(value.c_str())) > 1.0;
+      else {
+        for (size_t i = 0; i < modelOptions.size(); i++)
+          if (key == modelOptions[i]) {
+            if (atoi(value.c_str()) != 0 && !hasOption(key))
+              options.push_back(key);
+            return true;
+          }
+        error = "unknown key " + key;
+        return false;
+      }
+      if (!ok)
+        error = key == "dimension" ? "this program was built for dimension " + std::to_string(dimension)
+                                   : "bad value for " + key + ": " + value;
+      return ok;
+    }
+
+    // read a config file, the journal defaults to the output file name + ".journal"
+    bool read(const std::string &path, std::string &error) {
+      std::ifstream in(path.c_str());
+      if (!in) {
+        error = "cannot read " + path;
+        return false;
+      }
+      std::string line;
+      for (int n = 1; std::getline(in, line); n++) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+          line.erase(hash);
+        line = trim(line);
+        if (line.empty())
+          continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+          error = path + ":" + std::to_string(n) + ": expected key = value";
+          return false;
+        }
+        if (!set(trim(line.substr(0, eq)), trim(line.substr(eq + 1)), error)) {
+          error = path + ":" + std::to_string(n) + ": " + error;
+          return false;
+        }
+      }
+      if (output.empty()) {
+        error = path + ": no output file";
+        return false;
+      }
+      if (journal.empty())
+        journal = output + ".journal";
+      return true;
+    }
+
+    // all the jobs of the sweep: every endNum, prob and G, runs times each
+    std::vector<EnsembleJob> jobs() const {
+      std::vector<EnsembleJob> all;
+      std::vector<double> e = endNum.values(), p = prob.values(), g = G.values();
+      for (size_t i = 0; i < e.size(); i++)
+        for (size_t j = 0; j < p.size(); j++)
+          for (size_t k = 0; k < g.size(); k++)
+            for (int r = 0; r < runs; r++) {
+              EnsembleJob job = { (int)(e[i] + 0.5), p[j], g[k], seed + r };
+              all.push_back(job);
+            }
+      return all;
+    }
+};
+
+// append-only record of the jobs of a sweep that have finished, so that a sweep that was
+// killed (or whose machine crashed) can be restarted and only runs the jobs that are missing
+// the first line is "size bytes" (the size of the output file when the sweep started),
+// every other line is "endNum prob G seed bytes", where bytes is the size of the output file
+// once the results of that job were in it: anything after the last recorded size belongs
+// to a job that did not finish, and is cut off when the sweep restarts (so no duplicates)
+class Journal {
+  private:
+    FILE *file;
+    std::set<std::string> done;
+    long long outputBytes;  // size of the output file at the last recorded job
+
+    static std::string key(const EnsembleJob &job) {
+      char text[128];
+      snprintf(text, sizeof(text), "%d %.17g %.17g %d", job.endNum, job.prob, job.G, job.seed);
+      return text;
+    }
+
+  public:
+    Journal() : file(NULL), outputBytes(-1) {}
+    ~Journal() {
+      if (file != NULL)
+        fclose(file);
+    }
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    // read the jobs that are already done, cut the output file back to the last finished job,
+    // and open the journal for appending; returns false (with a reason in error) on failure
+    bool open(const std::string &path, const std::string &output, std::string &error) {
+      std::ifstream in(path.c_str());
+      std::string line;
+      long long journalBytes = 0;  // length of the complete lines
+      while (std::getline(in, line)) {
+        if (in.eof())
+          break;  // the last line was cut short by a crash (no newline)
+        std::istringstream fields(line);
+        std::string first;
+        EnsembleJob job;
+        long long bytes;
+        fields >> first;
+        if (first == "size" && fields >> bytes)
+          outputBytes = bytes;
+        else if (std::istringstream(line) >> job.endNum >> job.prob >> job.G >> job.seed >> bytes) {
+          done.insert(key(job));
+          outputBytes = bytes;
+        }
+        journalBytes += line.size() + 1;
+      }
+      in.close();
+
+      struct stat st;
+      long long size = stat(output.c_str(), &st) == 0 ? (long long)st.st_size : 0;
+      if (outputBytes >= 0) {
+        if (size < outputBytes) {
+          error = output + " is shorter than " + path + " says, not resuming";
+          return false;
+        }
+        if (size > outputBytes && truncate(output.c_str(), (off_t)outputBytes) != 0) {
+          error = "cannot cut unfinished results off " + output;
+          return false;
+        }
+      }
+      if (stat(path.c_str(), &st) == 0 && st.st_size > journalBytes
+          && truncate(path.c_str(), (off_t)journalBytes) != 0) {
+        error = "cannot cut the unfinished last line off " + path;
+        return false;
+      }
+
+      file = fopen(path.c_str(), "a");
+      if (file == NULL) {
+        error = "cannot write " + path;
+        return false;
+      }
+      // a new journal starts with the size of the output file (it may hold older results)
+      if (outputBytes < 0) {
+        fprintf(file, "size %lld\n", size);
+        fflush(file);
+        fsync(fileno(file));
+        outputBytes = size;
+      }
+      return true;
+    }
+
+    int getNumDone() const {
+      return (int)done.size();
+    }
+
+    bool isDone(const EnsembleJob &job) const {
+      return done.count(key(job)) > 0;
+    }
+
+    // job has finished and its results are in the output file, which is now bytes long
+    // (the line is on disk before this returns)
+    void record(const EnsembleJob &job, long long bytes) {
+      fprintf(file, "%s %lld\n", key(job).c_str(), bytes);
+      fflush(file);
+      fsync(fileno(file));
+      done.insert(key(job));
+      outputBytes = bytes;
+    }
+};
@@ -0,0 +1,178 @@
+//
+//  batchDLA.cpp
+//
+//  headless runner: grows one cluster without opening a window, so it can be
+//  used on machines with no display. Build it with "make dla-batch" in the directory
+//  of the model (2D DLA, 3D DLA or Gravitational model), it is the same file for all of them.
+//
+//  usage: dla-batch endNum prob seed dimension output.csv [options]
+//  options:
+//    --distance-map   jump across empty space using the distance map
+//    --pyramid        jump across empty space using the occupancy pyramid
+//    --first-passage  send walkers that leave the killCircle back to the addCircle
+//                     (not in the gravitational model)
+//    --G g            gravitational constant, 0 <= g < 1 (default 0, only in the gravitational model)
+//    --radius-jumps   jump across the empty space outside the cluster radius (not in the gravitational model)
+//    --geometric-sticking  draw how many sticking trials fail once per walker (faster at small prob)
+//    --walker-streams give every walker its own random numbers (set from the seed and its launch number)
+//    --speculative t  walk batches of walkers on t threads at once, with walker streams: the same
+//                     cluster and output as --walker-streams alone, bit for bit (not with --distance-map
+//                     or --pyramid)
+//    --batch k        walkers per batch for --speculative (default 2 per thread, at most 64)
+//    --every k        write a results line every k particles
+//                     (default every particle in 3D, only the finished cluster in 2D)
+//    --log-spaced f   write a results line at log-spaced sizes, each about f times the last
+//    --first n        size of the first checkpoint (default k, or 1 with --log-spaced)
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+
+#include "DLASystem.h"
+
+using namespace std;
+
+void usage(const char *name) {
+  cerr << "usage: " << name << " endNum prob seed dimension output.csv [options]" << endl;
+  cerr << "options:" << endl;
+  cerr << "  --distance-map   jump across empty space using the distance map" << endl;
+  cerr << "  --pyramid        jump across empty space using the occupancy pyramid" << endl;
+  if (DLASystem::Policy::firstPassage)
+    cerr << "  --first-passage  send walkers that leave the killCircle back to the addCircle" << endl;
+  if (DLASystem::Policy::hasGravity)
+    cerr << "  --G g            gravitational constant, 0 <= g < 1 (default 0)" << endl;
+  if (DLASystem::Policy::firstPassage)
+    cerr << "  --radius-jumps   jump across the empty space outside the cluster radius" << endl;
+  cerr << "  --geometric-sticking  draw how many sticking trials fail once per walker (faster at small prob)" << endl;
+  cerr << "  --walker-streams give every walker its own random numbers" << endl;
+  cerr << "  --speculative t  walk batches of walkers on t threads, the same output as --walker-streams" << endl;
+  cerr << "  --batch k        walkers per batch for --speculative (default 2 per thread, at most 64)" << endl;
+  if (DLASystem::Policy::summaryAtEnd)
+    cerr << "  --every k        write a results line every k particles (default only the finished cluster)" << endl;
+  else
+    cerr << "  --every k        write the stuck particle every k particles (default every particle)" << endl;
+  cerr << "  --log-spaced f   write a results line at log-spaced sizes, each about f times the last" << endl;
+  cerr << "  --first n        size of the first checkpoint (default k, or 1 with --log-spaced)" << endl;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 6) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  int endNum = atoi(argv[1]);
+  double prob = atof(argv[2]);
+  int seed = atoi(argv[3]);
+  int dimension = atoi(argv[4]);
+  string output(argv[5]);
+  int distanceMap = 0;
+  int pyramid = 0;
+  int firstPassage = 0;
+  int radiusJumps = 0;
+  double G = 0.0;
+  int geometricSticking = 0;
+  int walkerStreams = 0;
+  int speculative = 0;
+  int batch = 0;
+  int every = 0;
+  double factor = 0.0;
+  int first = 0;
+  for (int i = 6; i < argc; i++) {
+    string opt(argv[i]);
+    if (opt == "--distance-map")
+      distanceMap = 1;
+    else if (opt == "--pyramid")
+      pyramid = 1;
+    else if (opt == "--first-passage" && DLASystem::Policy::firstPassage)
+      firstPassage = 1;
+    else if (opt == "--G" && DLASystem::Policy::hasGravity && i + 1 < argc)
+      G = atof(argv[++i]);
+    else if (opt == "--radius-jumps" && DLASystem::Policy::firstPassage)
+      radiusJumps = 1;
+    else if (opt == "--geometric-sticking")
+      geometricSticking = 1;
+    else if (opt == "--walker-streams")
+      walkerStreams = 1;
+    else if (opt == "--speculative" && i + 1 < argc)
+      speculative = atoi(argv[++i]);
+    else if (opt == "--batch" && i + 1 < argc)
+      batch = atoi(argv[++i]);
+    else if (opt == "--every" && i + 1 < argc)
+      every = atoi(argv[++i]);
+    else if (opt == "--log-spaced" && i + 1 < argc)
+      factor = atof(argv[++i]);
+    else if (opt == "--first" && i + 1 < argc)
+      first = atoi(argv[++i]);
+    else {
+      cerr << "unknown option " << opt << endl;
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (endNum < 1 || prob <= 0.0 || prob > 1.0) {
+    cerr << "endNum must be positive and prob in (0,1]" << endl;
+    return 1;
+  }
+  if (G < 0.0 || G >= 1.0) {
+    cerr << "G must be at least 0 and below 1" << endl;
+    return 1;
+  }
+  if (every < 0 || first < 0 || (factor != 0.0 && factor <= 1.0)) {
+    cerr << "--every and --first must be positive and --log-spaced above 1" << endl;
+    return 1;
+  }
+  if (speculative < 0 || batch < 0 || batch > 64 || (speculative > 0 && (distanceMap || pyramid))) {
+    cerr << "--speculative needs a positive number of threads, --batch at most 64, and no --distance-map or --pyramid" << endl;
+    return 1;
+  }
+  // each model directory builds its own dla-batch
+  if (dimension != DLASystem::dim) {
+    cerr << "this dla-batch was built for dimension " << DLASystem::dim << endl;
+    return 1;
+  }
+
+  // no window: the simulation core does not touch OpenGL in headless builds
+  DLASystem *sys = new DLASystem(NULL);
+  sys->setSeed(seed);
+  sys->setProbability(prob);
+  sys->setOutputFile(output);
+  sys->setDistanceMapJumps(distanceMap);
+  sys->setPyramidJumps(pyramid);
+  sys->setFirstPassage(firstPassage);
+  sys->setRadiusJumps(radiusJumps);
+  sys->setG(G);
+  sys->setGeometricSticking(geometricSticking);
+  sys->setWalkerStreams(walkerStreams);
+  sys->setEndNum(endNum);
+  // one run reports every checkpoint size on the way to endNum
+  if (factor > 1.0)
+    sys->setLogCheckpoints(first > 0 ? first : 1, factor);
+  else if (every > 0)
+    sys->setCheckpoints(first > 0 ? first : every, every);
+  sys->setFast();
+  sys->setRunning();
+
+  // the cluster may reach the edge of the grid before endNum, checkStop() then pauses the system
+  if (speculative > 0)
+    sys->growSpeculative(speculative, batch > 0 ? batch : 2 * speculative);
+  else {
+    while (sys->running && sys->Update() == 0) {
+      // Do nothing, just keep updating
+    }
+  }
+
+  // the 2D model writes one summary line per run, like automateRun()
+  // (unless the last checkpoint already was the finished cluster)
+  sys->finishRun();
+
+  cout << "particles " << sys->getNumParticles() << " radius " << sys->getClusterRadius();
+  if (speculative > 0)
+    cout << " walkers " << sys->getSpeculated() << " speculated " << sys->getReplayed() << " replayed";
+  cout << endl;
+
+  delete sys;
+  return 0;
+}
@@ -0,0 +1,45 @@
+#!/bin/bash
+# scaling of dla-parallel: grows the same size of cluster with 1, 2, 4, ... threads (up to the number of cores)
+# and compares time, cluster radius and fractal dimension against one thread (which is serial DLA)
+# run it from the directory of a model: ../common/bench-parallel.sh [endNum]    (default 100000)
+# RUNS clusters per thread count (default 5), SEED, PROB, SIZE (--size) and OPTIONS (eg --radius-jumps)
+# are passed on to dla-parallel, THREADS overrides the list of thread counts
+# needs make and g++ (or CXX=...), it writes to bench/
+
+N=${1:-100000}
+RUNS=${RUNS:-5}
+SEED=${SEED:-1}
+PROB=${PROB:-1}
+CXX=${CXX:-g++}
+CORES=$(nproc 2>/dev/null || sysctl -n hw.ncpu)
+if [ -z "$THREADS" ]; then
+  THREADS=1
+  t=2
+  while [ $t -le $CORES ]; do
+    THREADS="$THREADS $t"
+    t=$((t * 2))
+  done
+fi
+dim=$(grep -o 'DLAEngine<[0-9]' DLASystem.h | head -1 | tr -dc '0-9')
+if [ -z "$dim" ]; then
+  echo "run it from the directory of a model (2D DLA, 3D DLA or Gravitational model)"
+  exit 1
+fi
+
+mkdir -p bench
+make dla-parallel CXX="$CXX" > bench/build-parallel.log 2>&1 || { echo "build failed, see bench/build-parallel.log"; exit 1; }
+size=""
+[ -n "$SIZE" ] && size="--size $SIZE"
+
+printf "%8s %10s %10s %18s %10s\n" threads seconds speedup radius dimension
+for t in $THREADS; do
+  rm -f bench/parallel-$t.csv
+  ./dla-parallel $N $PROB $SEED $dim bench/parallel-$t.csv --threads $t --runs $RUNS $size $OPTIONS > /dev/null || exit 1
+  # mean time, mean radius and its standard error, mean fractal dimension
+  awk -F, -v t=$t -v base="$base" '{ s += $7; r += $5; rr += $5 * $5; f += $6; n++ }
+    END { r /= n; se = (n > 1) ? sqrt((rr / n - r * r) / (n - 1)) : 0; s /= n
+          printf "%8d %10.2f %10.2f %10.2f +- %5.2f %10.3f\n", t, s, (base == "") ? 1 : base / s, r, se, f / n }' bench/parallel-$t.csv
+  if [ -z "$base" ]; then
+    base=$(awk -F, '{ s += $7; n++ } END { print s / n }' bench/parallel-$t.csv)
+  fi
+done
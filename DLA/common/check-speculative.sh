@@ -0,0 +1,44 @@
+#!/bin/bash
+# checks that --speculative grows the cluster of --walker-streams bit for bit: grows a few seeds and sizes
+# with --walker-streams alone and with --speculative for several threads and batch sizes, and cmp's the outputs
+# run it from the directory of a model: ../common/check-speculative.sh [endNum ...]    (default 2000 10000)
+# SEEDS (default "1 7"), PROB (default 1 and 0.3) and OPTIONS (eg --radius-jumps --first-passage) are passed
+# on to dla-batch, SPECULATIVE lists the threads:batch pairs to try
+# needs make and g++ (or CXX=...), it writes to bench/ and exits with 1 if any output differs
+
+SIZES=${@:-2000 10000}
+SEEDS=${SEEDS:-1 7}
+PROB=${PROB:-1 0.3}
+SPECULATIVE=${SPECULATIVE:-1:1 1:16 2:8 3:5 4:64}
+CXX=${CXX:-g++}
+dim=$(grep -o 'DLAEngine<[0-9]' DLASystem.h | head -1 | tr -dc '0-9')
+if [ -z "$dim" ]; then
+  echo "run it from the directory of a model (2D DLA, 3D DLA or Gravitational model)"
+  exit 1
+fi
+
+mkdir -p bench
+make dla-batch CXX="$CXX" > bench/build-speculative.log 2>&1 || { echo "build failed, see bench/build-speculative.log"; exit 1; }
+
+printf "%10s %6s %6s %8s %8s %6s\n" endNum prob seed threads batch same
+failed=0
+for n in $SIZES; do
+  for p in $PROB; do
+    for seed in $SEEDS; do
+      rm -f bench/streams.csv
+      ./dla-batch $n $p $seed $dim bench/streams.csv --every 1 --walker-streams $OPTIONS > /dev/null || exit 1
+      for tb in $SPECULATIVE; do
+        rm -f bench/speculative.csv
+        ./dla-batch $n $p $seed $dim bench/speculative.csv --every 1 --speculative ${tb%:*} --batch ${tb#*:} $OPTIONS > /dev/null || exit 1
+        if cmp -s bench/streams.csv bench/speculative.csv; then
+          same=yes
+        else
+          same=NO
+          failed=1
+        fi
+        printf "%10s %6s %6s %8s %8s %6s\n" $n $p $seed ${tb%:*} ${tb#*:} $same
+      done
+    done
+  done
+done
+exit $failed
@@ -0,0 +1,224 @@
+//
+//  ensembleDLA.cpp
+//
+//  headless ensemble runner: grows many clusters (runs x sticking probabilities x G)
+//  on all cores at once. Every thread has its own DLASystem (own grid and random numbers)
+//  and threads that run out of work steal jobs from the others, so slow jobs (small prob)
+//  do not leave cores idle. Build it with "make dla-ensemble" in the directory of the model
+//  (2D DLA, 3D DLA or Gravitational model), it is the same file for all of them.
+//
+//  usage: dla-ensemble sweep.cfg
+//     or: dla-ensemble endNum runs seed dimension output.csv [options]
+//  run r uses seed+r, so every point of the sweep sees the same seeds
+//  options (or "key = value" lines of the config file, see Sweep.h):
+//    --threads t              number of threads (default one per core)
+//    --prob p                 sticking probability (default 1)
+//    --prob-range p0 p1 step  one set of runs for every probability p0, p0+step, ... up to p1
+//    --G g                    gravitational constant, 0 <= g < 1 (default 0, only the gravitational model)
+//    --G-range g0 g1 step     one set of runs for every G g0, g0+step, ... up to g1
+//    --journal file           record finished jobs in file, and skip them when restarted
+//                             (a config file always has a journal, by default output.csv.journal)
+//    --distance-map           jump across empty space using the distance map
+//    --pyramid                jump across empty space using the occupancy pyramid
+//    --first-passage          send walkers that leave the killCircle back to the addCircle
+//                             (not in the gravitational model)
+//    --radius-jumps           jump across the empty space outside the cluster radius
+//                             (not in the gravitational model)
+//    --geometric-sticking     draw how many sticking trials fail once per walker (faster at small prob)
+//    --every k                write a results line every k particles
+//                             (default every particle in 3D, only the finished cluster in 2D)
+//    --log-spaced f           write a results line at log-spaced sizes, each about f times the last
+//    --first n                size of the first checkpoint (default k, or 1 with --log-spaced)
+//
+//  the results of a job only reach output.csv once the whole job has finished,
+//  so a sweep that is killed and restarted never writes anything twice
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "DLASystem.h"
+#include "Ensemble.h"
+#include "Sweep.h"
+
+using namespace std;
+
+void usage(const char *name) {
+  cerr << "usage: " << name << " sweep.cfg" << endl;
+  cerr << "   or: " << name << " endNum runs seed dimension output.csv [options]" << endl;
+  cerr << "options:" << endl;
+  cerr << "  --threads t              number of threads (default one per core)" << endl;
+  cerr << "  --prob p                 sticking probability (default 1)" << endl;
+  cerr << "  --prob-range p0 p1 step  one set of runs for every probability p0, p0+step, ... up to p1" << endl;
+  if (DLASystem::Policy::hasGravity) {
+    cerr << "  --G g                    gravitational constant, 0 <= g < 1 (default 0)" << endl;
+    cerr << "  --G-range g0 g1 step     one set of runs for every G g0, g0+step, ... up to g1" << endl;
+  }
+  cerr << "  --journal file           record finished jobs in file, and skip them when restarted" << endl;
+  cerr << "  --distance-map           jump across empty space using the distance map" << endl;
+  cerr << "  --pyramid                jump across empty space using the occupancy pyramid" << endl;
+  if (DLASystem::Policy::firstPassage)
+    cerr << "  --first-passage          send walkers that leave the killCircle back to the addCircle" << endl;
+  if (DLASystem::Policy::firstPassage)
+    cerr << "  --radius-jumps           jump across the empty space outside the cluster radius" << endl;
+  cerr << "  --geometric-sticking     draw how many sticking trials fail once per walker (faster at small prob)" << endl;
+  if (DLASystem::Policy::summaryAtEnd)
+    cerr << "  --every k                write a results line every k particles (default only the finished cluster)" << endl;
+  else
+    cerr << "  --every k                write the stuck particle every k particles (default every particle)" << endl;
+  cerr << "  --log-spaced f           write a results line at log-spaced sizes, each about f times the last" << endl;
+  cerr << "  --first n                size of the first checkpoint (default k, or 1 with --log-spaced)" << endl;
+}
+
+int main(int argc, char **argv) {
+  // the on/off options of this model
+  vector<string> modelOptions = { "distance-map", "pyramid", "geometric-sticking" };
+  if (DLASystem::Policy::firstPassage) {
+    modelOptions.push_back("first-passage");
+    modelOptions.push_back("radius-jumps");
+  }
+  SweepConfig cfg(DLASystem::dim, modelOptions);
+  string error;
+
+  if (argc == 2) {
+    if (!cfg.read(argv[1], error)) {
+      cerr << error << endl;
+      return 1;
+    }
+  }
+  else if (argc >= 6) {
+    if (!cfg.set("endNum", argv[1], error) || !cfg.set("runs", argv[2], error)
+        || !cfg.set("seed", argv[3], error) || !cfg.set("dimension", argv[4], error)
+        || !cfg.set("output", argv[5], error)) {
+      cerr << error << endl;
+      return 1;
+    }
+    for (int i = 6; i < argc; i++) {
+      string opt(argv[i]);
+      if (opt.compare(0, 2, "--") != 0) {
+        cerr << "unknown option " << opt << endl;
+        usage(argv[0]);
+        return 1;
+      }
+      string key = opt.substr(2);
+      string value;
+      if ((key == "prob-range" || key == "G-range") && i + 3 < argc) {
+        key = key.substr(0, key.size() - 6);
+        value = string(argv[i + 1]) + " " + argv[i + 2] + " " + argv[i + 3];
+        i += 3;
+      }
+      else if (key == "distance-map" || key == "pyramid" || key == "first-passage" || key == "radius-jumps"
+               || key == "geometric-sticking")
+        value = "1";
+      else if (i + 1 < argc)
+        value = argv[++i];
+      if (!cfg.set(key, value, error)) {
+        cerr << error << endl;
+        usage(argv[0]);
+        return 1;
+      }
+    }
+  }
+  else {
+    usage(argv[0]);
+    return 1;
+  }
+  // each model directory builds its own dla-ensemble
+  if (!DLASystem::Policy::hasGravity && (cfg.G.from != 0.0 || cfg.G.to != 0.0)) {
+    cerr << "this model has no gravity (G), use the gravitational model's dla-ensemble" << endl;
+    return 1;
+  }
+  // G is how often a hop is pulled towards the cluster (see ModelGravity::hop), at 1 a walker
+  // in a pocket of the cluster can be pulled against it forever
+  if (cfg.G.from < 0.0 || cfg.G.from >= 1.0 || cfg.G.to < 0.0 || cfg.G.to >= 1.0) {
+    cerr << "G must be at least 0 and below 1" << endl;
+    return 1;
+  }
+
+  // which jobs are done already (only with a journal)
+  Journal journal;
+  if (!cfg.journal.empty() && !journal.open(cfg.journal, cfg.output, error)) {
+    cerr << error << endl;
+    return 1;
+  }
+  FILE *out = fopen(cfg.output.c_str(), "a");
+  if (out == NULL) {
+    cerr << "cannot write " << cfg.output << endl;
+    return 1;
+  }
+
+  // the jobs: every endNum, probability and G of the sweep, runs times each
+  Ensemble ensemble(cfg.threads);
+  vector<EnsembleJob> jobs = cfg.jobs();
+  for (size_t j = 0; j < jobs.size(); j++)
+    if (!journal.isDone(jobs[j]))
+      ensemble.add(jobs[j]);
+
+  // one system per thread, set up once and reset before every job
+  vector<DLASystem*> systems;
+  for (int t = 0; t < ensemble.getThreads(); t++) {
+    DLASystem *sys = new DLASystem(NULL);
+    sys->holdResults();  // the results of each job are written out below, once it has finished
+    sys->setDistanceMapJumps(cfg.hasOption("distance-map"));
+    sys->setPyramidJumps(cfg.hasOption("pyramid"));
+    sys->setFirstPassage(cfg.hasOption("first-passage"));
+    sys->setRadiusJumps(cfg.hasOption("radius-jumps"));
+    sys->setGeometricSticking(cfg.hasOption("geometric-sticking"));
+    if (cfg.factor > 1.0)
+      sys->setLogCheckpoints(cfg.first > 0 ? cfg.first : 1, cfg.factor);
+    else if (cfg.every > 0)
+      sys->setCheckpoints(cfg.first > 0 ? cfg.first : cfg.every, cfg.every);
+    sys->setFast();
+    systems.push_back(sys);
+  }
+
+  cout << ensemble.getNumJobs() << " jobs on " << ensemble.getThreads() << " threads";
+  if (!cfg.journal.empty())
+    cout << " (" << jobs.size() - ensemble.getNumJobs() << " already done)";
+  cout << endl;
+
+  mutex outLock;
+  ensemble.run([&](int t, const EnsembleJob &job) {
+    DLASystem *sys = systems[t];
+    sys->Reset();
+    sys->setSeed(job.seed);
+    sys->setProbability(job.prob);
+    sys->setG(job.G);
+    sys->setEndNum(job.endNum);
+    sys->setRunning();
+
+    // the cluster may reach the edge of the grid before endNum, checkStop() then pauses the system
+    while (sys->running && sys->Update() == 0) {
+      // Do nothing, just keep updating
+    }
+
+    // the 2D model writes one summary line per run, like automateRun()
+    // (unless the last checkpoint already was the finished cluster)
+    sys->finishRun();
+
+    // all the results of the job go into the output file in one piece, then into the journal
+    string text = sys->takeResults();
+    lock_guard<mutex> lock(outLock);
+    fwrite(text.data(), 1, text.size(), out);
+    fflush(out);
+    if (!cfg.journal.empty()) {
+      fsync(fileno(out));
+      journal.record(job, (long long)ftello(out));
+    }
+    cout << "endNum " << job.endNum << " prob " << job.prob;
+    if (DLASystem::Policy::hasGravity)
+      cout << " G " << job.G;
+    cout << " seed " << job.seed
+         << " particles " << sys->getNumParticles() << " radius " << sys->getClusterRadius() << endl;
+  });
+
+  cout << "done, " << ensemble.getStolen() << " jobs stolen" << endl;
+
+  for (size_t t = 0; t < systems.size(); t++)
+    delete systems[t];
+  fclose(out);
+  return 0;
+}
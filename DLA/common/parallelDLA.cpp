@@ -0,0 +1,114 @@
+//
+//  parallelDLA.cpp
+//
+//  headless runner for very big single clusters: many threads grow the same cluster at once
+//  (see ParallelGrowth.h for how this differs from serial DLA). Build it with "make dla-parallel"
+//  in the directory of the model (2D DLA, 3D DLA or Gravitational model).
+//
+//  usage: dla-parallel endNum prob seed dimension output.csv [options]
+//  run r seeds its threads with seed + r*threads, seed + r*threads + 1, ...
+//  options:
+//    --threads t      number of threads (default one per core)
+//    --runs r         grow r clusters one after the other (default 1)
+//    --size L         the lattice is L^dimension sites (default the model's gridSize)
+//    --radius-jumps   jump across the empty space outside the cluster radius (not in the gravitational model)
+//  one line per cluster is appended to output.csv:
+//    threads, particles, prob, seed, cluster radius, fractal dimension, seconds, walkers launched
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include <thread>
+
+#include "DLASystem.h"
+#include "ParallelGrowth.h"
+
+using namespace std;
+
+void usage(const char *name) {
+  cerr << "usage: " << name << " endNum prob seed dimension output.csv [options]" << endl;
+  cerr << "options:" << endl;
+  cerr << "  --threads t      number of threads (default one per core)" << endl;
+  cerr << "  --runs r         grow r clusters one after the other (default 1)" << endl;
+  cerr << "  --size L         the lattice is L^dimension sites (default " << DLASystem::Policy::gridSize << ")" << endl;
+  if (DLASystem::Policy::firstPassage)
+    cerr << "  --radius-jumps   jump across the empty space outside the cluster radius" << endl;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 6) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  int endNum = atoi(argv[1]);
+  double prob = atof(argv[2]);
+  int seed = atoi(argv[3]);
+  int dimension = atoi(argv[4]);
+  string output(argv[5]);
+  int threads = (int)thread::hardware_concurrency();
+  int runs = 1;
+  int size = DLASystem::Policy::gridSize;
+  int radiusJumps = 0;
+  for (int i = 6; i < argc; i++) {
+    string opt(argv[i]);
+    if (opt == "--threads" && i + 1 < argc)
+      threads = atoi(argv[++i]);
+    else if (opt == "--runs" && i + 1 < argc)
+      runs = atoi(argv[++i]);
+    else if (opt == "--size" && i + 1 < argc)
+      size = atoi(argv[++i]);
+    else if (opt == "--radius-jumps" && DLASystem::Policy::firstPassage)
+      radiusJumps = 1;
+    else {
+      cerr << "unknown option " << opt << endl;
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (endNum < 1 || prob <= 0.0 || prob > 1.0) {
+    cerr << "endNum must be positive and prob in (0,1]" << endl;
+    return 1;
+  }
+  if (threads < 1 || runs < 1 || size < 64) {
+    cerr << "--threads and --runs must be positive and --size at least 64" << endl;
+    return 1;
+  }
+  // each model directory builds its own dla-parallel
+  if (dimension != DLASystem::dim) {
+    cerr << "this dla-parallel was built for dimension " << DLASystem::dim << endl;
+    return 1;
+  }
+
+  FILE *out = fopen(output.c_str(), "a");
+  if (out == NULL) {
+    cerr << "cannot write " << output << endl;
+    return 1;
+  }
+
+  for (int r = 0; r < runs; r++) {
+    int runSeed = seed + r * threads;
+    ParallelGrowth<DLASystem::dim, DLASystem::Policy> growth(size, endNum, prob);
+    growth.setRadiusJumps(radiusJumps);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    growth.grow(threads, runSeed);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int n = growth.getNumParticles();
+    double radius = growth.getClusterRadius();
+    fprintf(out, "%d,%d,%g,%d,%g,%g,%g,%lld\n", threads, n, prob, runSeed, radius, log((double)n) / log(radius),
+            seconds, (long long)growth.getLaunched());
+    fflush(out);
+    cout << "threads " << threads << " particles " << n << " radius " << radius << " seconds " << seconds;
+    if (growth.getReachedEdge())
+      cout << " (stopped at the edge of the lattice, use a bigger --size)";
+    cout << endl;
+  }
+
+  fclose(out);
+  return 0;
+}
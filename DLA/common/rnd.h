@@ -0,0 +1,105 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// ... don't worry how this all works
+// ... member functions that you may want to use:
+//       random01() returns a random double between 0 and 1
+//       randomInt(max) returns a random int between 0 and max-1 (inclusive)
+//       randomHop(max) the same for small max (up to 8), e.g. which neighbour to hop to,
+//                      several of these come out of every 64 random bits
+//       bernoulli(t) returns true with probability p, where t = threshold(p)
+//       geometric(l) how many bernoulli trials fail before the first success, where l = log(1-p)
+
+class rnd {
+private:
+	// nuts and bolts.. should not need to touch this.
+	// the generator is xoshiro256** (Blackman & Vigna), seeded through splitmix64
+	uint64_t s[4];
+	// random bits left over from the last call to randomHop
+	uint64_t hopBits;
+	int hopBitsLeft;
+
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	static uint64_t splitmix64(uint64_t &x) {
+		uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+
+public:
+	// constructor
+	rnd() { setSeed(1); }
+
+	// set the random seed: the same seed always gives the same sequence
+	void setSeed(int seed) {
+		uint64_t x = (uint64_t)(int64_t)seed;
+		for (int i = 0; i < 4; i++)
+			s[i] = splitmix64(x);
+		hopBits = 0;
+		hopBitsLeft = 0;
+	}
+
+	// set the seed of one of many streams: the same seed and stream always give the same sequence
+	// (seed and stream are mixed before the state is filled, so neighbouring streams start far apart)
+	void setSeed(int seed, uint64_t stream) {
+		uint64_t x = (uint64_t)(int64_t)seed;
+		x = splitmix64(x) ^ (stream * 0xd1b54a32d192ed03ULL);
+		for (int i = 0; i < 4; i++)
+			s[i] = splitmix64(x);
+		hopBits = 0;
+		hopBitsLeft = 0;
+	}
+
+	// 64 random bits
+	uint64_t next() {
+		uint64_t result = rotl(s[1] * 5, 7) * 9;
+		uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+
+	// member functions for generating random double in [0,1) and random integer in [0,max-1]
+	double random01() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+	int    randomInt(int max) { return (int)(((next() >> 32) * (uint64_t)max) >> 32); }
+
+	// random integer in [0,max-1] for max <= 8, using 1, 2 or 3 bits at a time
+	// (values >= max are thrown away, so every result is exactly equally likely)
+	int randomHop(int max) {
+		int width = max <= 2 ? 1 : (max <= 4 ? 2 : 3);
+		uint64_t mask = ((uint64_t)1 << width) - 1;
+		while (true) {
+			if (hopBitsLeft < width) {
+				hopBits = next();
+				hopBitsLeft = 64;
+			}
+			int r = (int)(hopBits & mask);
+			hopBits >>= width;
+			hopBitsLeft -= width;
+			if (r < max)
+				return r;
+		}
+	}
+
+	// integer threshold for bernoulli(): p scaled to 53 bits
+	static uint64_t threshold(double p) {
+		if (p <= 0.0) return 0;
+		if (p >= 1.0) return (uint64_t)1 << 53;
+		return (uint64_t)(p * 9007199254740992.0);
+	}
+	// true with probability p (where t = threshold(p)), decided by one integer comparison
+	bool bernoulli(uint64_t t) { return (next() >> 11) < t; }
+	// number of failures before the first success of trials with probability p, where l = log(1-p)
+	// (l = -infinity for p = 1), capped at 2^62 for tiny p
+	int64_t geometric(double l) {
+		double k = floor(log(1.0 - random01()) / l);
+		return k < 4.6e18 ? (int64_t)k : ((int64_t)1 << 62);
+	}
+};